@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Position.h"
+#include "History.h"
+
+using namespace std;
+
+// Состояние доски без отрисовки: матрица фигур и история ходов.
+// Board добавляет к нему окно SDL, а безоконные инструменты (арена ботов) используют его напрямую.
+class BoardState
+{
+public:
+    BoardState() = default;
+    virtual ~BoardState() = default;
+
+    // Возвращает доску в начальную позицию и очищает историю
+    void reset()
+    {
+        make_start_mtx(); // Восстанавливаем начальную позицию и начинаем историю с неё
+    }
+
+    // Ставит на доску произвольную позицию и начинает историю с неё
+    void set_board(const vector<vector<POS_T>>& board_mtx)
+    {
+        mtx = board_mtx;
+        history.reset(mtx);
+        on_change(); // Сообщаем об изменении доски
+    }
+
+    // Метод для перемещения фигуры на новую позицию
+    void move_piece(move_pos turn, const int beat_series = 0)
+    {
+        make_move(turn.x, turn.y, turn.x2, turn.y2, turn.xb, turn.yb, beat_series);
+    }
+
+    // Основной метод перемещения фигуры
+    void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
+    {
+        make_move(i, j, i2, j2, -1, -1, beat_series);
+    }
+
+    // Метод удаления фигуры с указанной позиции
+    void drop_piece(const POS_T i, const POS_T j)
+    {
+        mtx[i][j] = 0; // Обнуляется позиция
+        on_change(); // Сообщаем об изменении доски
+    }
+
+    // Метод превращения фигуры в даму
+    void turn_into_queen(const POS_T i, const POS_T j)
+    {
+        if (mtx[i][j] == 0 || mtx[i][j] > 2) // Если позиция пустая или уже дамка
+            throw runtime_error("can't turn into queen in this position");
+        mtx[i][j] += 2; // Повышаем ранг фигуры до дамы
+        on_change(); // Сообщаем об изменении доски
+    }
+
+    // Метод для получения текущей матрицы доски
+    vector<vector<POS_T>> get_board() const
+    {
+        return mtx;
+    }
+
+    // Метод отката последних ходов
+    void rollback()
+    {
+        if (history.empty())
+            return;
+        int beat_series = max(1, int(history.back().beat_series)); // Берем последнюю серию ударов
+        while (beat_series-- && !history.empty()) // Пока есть ходы для отката
+            History::revert(history.pop(), mtx); // Отменяем шаг обратным применением записи
+        on_change(); // Сообщаем об изменении доски
+    }
+
+protected:
+    // Вызывается при каждом изменении расположения фигур (Board отмечает, что кадр на экране устарел)
+    virtual void on_change()
+    {}
+
+    // Перемещение фигуры с записью шага в историю (xb, yb — сбитая фигура или -1)
+    void make_move(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const POS_T xb, const POS_T yb,
+                   const int beat_series)
+    {
+        if (mtx[i2][j2]) // Если конечная позиция занята
+            throw runtime_error("final position is not empty, can't move");
+        if (!mtx[i][j]) // Если начальная позиция свободна
+            throw runtime_error("begin position is empty, can't move");
+        history_step step;
+        step.from = int8_t(Position::square(i, j));
+        step.to = int8_t(Position::square(i2, j2));
+        if (xb != -1) // Если был произведен удар
+        {
+            step.captured = int8_t(Position::square(xb, yb));
+            step.captured_piece = uint8_t(mtx[xb][yb]);
+        }
+        step.promoted = (mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7); // Фигура дошла до крайней линии
+        step.beat_series = uint8_t(beat_series);
+        History::apply(step, mtx); // Перемещаем фигуру (и убираем сбитую)
+        history.push(step, mtx); // Добавляем ход в историю
+        on_change(); // Сообщаем об изменении доски
+    }
+
+    // Метод формирования начальной матрицы расположения фигур
+    void make_start_mtx()
+    {
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                mtx[i][j] = 0; // Инициализируем всю доску нулями
+                if (i < 3 && (i + j) % 2 == 1) // Располагаем черные фигуры
+                    mtx[i][j] = 2;
+                if (i > 4 && (i + j) % 2 == 1) // Располагаем белые фигуры
+                    mtx[i][j] = 1;
+            }
+        }
+        history.reset(mtx); // Начальное состояние — начало истории
+        on_change(); // Сообщаем об изменении доски
+    }
+
+public:
+    // История партии: начальная доска и журнал шагов (см. History)
+    History history;
+
+protected:
+    // Матрица состояния игры
+    vector<vector<POS_T>> mtx = vector<vector<POS_T>>(8, vector<POS_T>(8));
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Logic.h"
+
+// Поиск хода бота в отдельном потоке, чтобы главный поток продолжал обрабатывать события окна
+//
+// Пока поиск идёт, доска только читается (поиск переводит её в позицию при старте),
+// поэтому менять её можно лишь после ready() или cancel().
+class BotSearch
+{
+public:
+    // Параметры:
+    // - logic: бот, который ищет ход
+    // - on_done: вызывается из потока поиска по его окончании (например, чтобы разбудить главный поток)
+    explicit BotSearch(Logic* logic, function<void()> on_done = {}) : logic(logic), on_done(move(on_done))
+    {}
+    BotSearch(const BotSearch&) = delete;
+    BotSearch& operator=(const BotSearch&) = delete;
+    ~BotSearch()
+    {
+        cancel();
+    }
+
+    // Запускает поиск хода для игрока color
+    void start(const bool color)
+    {
+        cancel();
+        logic->resume();
+        done.store(false);
+        worker = thread([this, color]() {
+            result = logic->find_best_turns(color);
+            done.store(true, memory_order_release);
+            if (on_done)
+                on_done();
+        });
+    }
+
+    // Поиск закончен, ход можно забрать через get()
+    bool ready() const
+    {
+        return done.load(memory_order_acquire);
+    }
+
+    // Дожидается окончания поиска и возвращает найденную последовательность ходов
+    vector<move_pos> get()
+    {
+        if (worker.joinable())
+            worker.join();
+        return result;
+    }
+
+    // Прерывает поиск и дожидается остановки потока; найденный ход отбрасывается.
+    // Поиск проверяет флаг прерывания в каждом узле, поэтому ожидание занимает доли миллисекунды.
+    void cancel()
+    {
+        if (!worker.joinable())
+            return;
+        logic->cancel();
+        worker.join();
+        result.clear();
+    }
+
+private:
+    Logic* logic;
+    function<void()> on_done;
+    thread worker;
+    atomic<bool> done{false};
+    vector<move_pos> result;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <fstream>
+#include <string>
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
@@ -9,33 +10,48 @@ class Config
 {
 public:
     /// Конструктор, инициализирует объект класса загрузкой начальных настроек
-    Config()
+    Config() : Config(project_path + "settings.json")
+    {}
+
+    /// Конструктор с явным путём к файлу настроек (например, для арены с двумя конфигурациями ботов)
+    explicit Config(const std::string& path) : path(path)
     {
         reload();
     }
 
-    /// Функция reload() обновляет конфигурацию, считывая её из файла settings.json
+    /// Функция reload() обновляет конфигурацию, считывая её из файла настроек
     ///
     /// Эта функция открывает указанный файл конфигурации и записывает его содержание
     /// в переменную-член 'config'. После изменения настроек в файле эта функция должна
     /// быть вызвана для обновления внутренних  данных.
+    /// Файл может содержать комментарии "//", как settings.json.
     void reload()
     {
-        std::ifstream fin(project_path + "settings.json"); // Открываем файл настроек
-        fin >> config;                                     // Читаем данные в переменную config
+        std::ifstream fin(path);                           // Открываем файл настроек
+        config = json::parse(fin, nullptr, true, true);    // Читаем данные в переменную config, пропуская комментарии
         fin.close();                                       // Закрываем файл
     }
 
+    /// Изменяет значение параметра в памяти (файл настроек не перезаписывается)
+    void set(const std::string& setting_dir, const std::string& setting_name, const json& value)
+    {
+        config[setting_dir][setting_name] = value;
+    }
+
     /// Операция обращения к классу Config как к функции с двумя аргументами
     ///
     /// Позволяет обращаться к объекту класса Config как к функции, передавая два аргумента:
     /// setting_dir (каталог параметра) и setting_name (название конкретного параметра),
     /// возвращая соответствующее значение из JSON-конфигурации.
+    /// Для отсутствующего параметра возвращается null (старые файлы настроек без новых параметров).
     auto operator()(const std::string& setting_dir, const std::string& setting_name) const
     {
+        if (!config.contains(setting_dir) || !config[setting_dir].contains(setting_name))
+            return json();
         return config[setting_dir][setting_name]; // Возвращает значение параметра из JSON
     }
 
 private:
+    std::string path; ///< Путь к файлу настроек
     json config; ///< Переменная хранит данные конфигурации в виде JSON
 };
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#ifdef __APPLE__
+    #include <SDL2/SDL.h>
+#else
+    #include <SDL.h>
+#endif
+
+using namespace std;
+
+// Ожидание событий окна без холостого опроса
+//
+// Поток спит в SDL_WaitEventTimeout до прихода события, до ближайшего тика или до конца ожидания.
+// Подсистемы подписываются на типы событий (обработчик вызывается до того, как событие получит
+// ожидающий) и добавляют тики — действия, выполняемые с заданным периодом, пока главный поток ждёт.
+// Другие потоки будят ожидание через wake() (например, когда поиск бота закончен).
+class EventDispatcher
+{
+public:
+    using Handler = function<void(const SDL_Event&)>;
+    using Tick = function<void()>;
+
+    EventDispatcher()
+    {
+        wake_event(); // тип события регистрируется в главном потоке
+    }
+
+    // Подписка на события типа type (SDL_WINDOWEVENT, SDL_QUIT и т.п.)
+    void subscribe(const Uint32 type, Handler handler)
+    {
+        handlers.push_back({type, move(handler)});
+    }
+
+    // Добавляет тик с периодом interval_ms, возвращает его номер для remove_tick
+    size_t add_tick(const Uint32 interval_ms, Tick tick)
+    {
+        ticks.push_back({++last_tick_id, chrono::milliseconds(interval_ms),
+                         chrono::steady_clock::now() + chrono::milliseconds(interval_ms), move(tick)});
+        return last_tick_id;
+    }
+
+    void remove_tick(const size_t id)
+    {
+        ticks.erase(remove_if(ticks.begin(), ticks.end(), [id](const tick_entry& t) { return t.id == id; }),
+                    ticks.end());
+    }
+
+    // Ждёт следующее событие не дольше timeout_ms (-1 — без ограничения), выполняя тики по расписанию
+    //
+    // Возвращает false, если время вышло или ожидание прервал wake()
+    bool wait(SDL_Event& event, const int timeout_ms = -1)
+    {
+        const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(max(timeout_ms, 0));
+        while (true)
+        {
+            run_ticks();
+            auto now = chrono::steady_clock::now();
+            // спим до ближайшего из сроков: конца ожидания и следующего тика
+            auto until = (timeout_ms < 0 ? chrono::steady_clock::time_point::max() : deadline);
+            for (const auto& t : ticks)
+                until = min(until, t.due);
+            int got;
+            if (until == chrono::steady_clock::time_point::max())
+                got = SDL_WaitEvent(&event);
+            else
+                got = SDL_WaitEventTimeout(&event, int(max<long long>(
+                    0, chrono::duration_cast<chrono::milliseconds>(until - now + chrono::microseconds(999)).count())));
+            if (got)
+            {
+                if (event.type == wake_event())
+                    return false;
+                for (const auto& h : handlers)
+                    if (h.type == event.type)
+                        h.handler(event);
+                return true;
+            }
+            if (timeout_ms >= 0 && chrono::steady_clock::now() >= deadline)
+                return false;
+        }
+    }
+
+    // Прерывает ожидание в главном потоке; можно вызывать из любого потока
+    static void wake()
+    {
+        SDL_Event event{};
+        event.type = wake_event();
+        SDL_PushEvent(&event);
+    }
+
+private:
+    // Тип пользовательского события, которым будят ожидание
+    static Uint32 wake_event()
+    {
+        static const Uint32 type = SDL_RegisterEvents(1);
+        return type;
+    }
+
+    // Выполняет тики, срок которых наступил
+    void run_ticks()
+    {
+        const auto now = chrono::steady_clock::now();
+        for (size_t i = 0; i < ticks.size(); ++i)
+        {
+            if (ticks[i].due > now)
+                continue;
+            ticks[i].due = now + ticks[i].interval;
+            // тик может добавлять и удалять тики: вызываем копию, а обходим по индексу
+            const Tick tick = ticks[i].tick;
+            tick();
+        }
+    }
+
+    struct handler_entry
+    {
+        Uint32 type;
+        Handler handler;
+    };
+    struct tick_entry
+    {
+        size_t id;
+        chrono::milliseconds interval;
+        chrono::steady_clock::time_point due;
+        Tick tick;
+    };
+
+    vector<handler_entry> handlers;
+    vector<tick_entry> ticks;
+    size_t last_tick_id = 0;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Move_list.h"
+#include "../Models/Position.h"
+#include "Logic.h"
+
+using namespace std;
+
+// Перебор полных ходов позиции: серия взятий — один ход, каждая различная серия — отдельный ход.
+// Общий для инструментов (perft, эндшпильная база, дебютная книга), которым нужны позиции после
+// полного хода, а не отдельные шаги, как в поиске.
+class FullMoves
+{
+public:
+    // Вызывает f(after, line) для каждого полного хода из позиции pos:
+    // after — позиция после хода (ход уже передан сопернику), line — шаги хода.
+    // Позиция меняется на время перебора и восстанавливается к его концу.
+    // Из f можно снова вызывать for_each для позиции after (так устроен perft).
+    template <class F> void for_each(Position& pos, F&& f)
+    {
+        if (nesting == lines.size())
+            lines.emplace_back();
+        vector<move_pos>& line = lines[nesting++];
+        line.clear();
+        expand(pos, -1, -1, f, line);
+        --nesting;
+    }
+
+    // Запись хода: "c3-d4" для тихого хода, "c3:e5:g3" для серии взятий
+    static string notation(const vector<move_pos>& line)
+    {
+        string text = Position::square_name(Position::square(line.front().x, line.front().y));
+        for (const move_pos& turn : line)
+            text += (turn.xb == -1 ? "-" : ":") + Position::square_name(Position::square(turn.x2, turn.y2));
+        return text;
+    }
+
+    // Лучшая линия после поиска logic из позиции pos: ход best и его продолжение по ходам из таблицы
+    // транспозиций, не длиннее length ходов (записи ходов, см. notation)
+    //
+    // Таблица хранит только первый шаг хода, поэтому из серий взятий с одинаковым первым шагом
+    // берётся первая найденная. Линия обрывается на позиции без записи и на повторе позиции.
+    vector<string> principal_variation(const Logic& logic, Position pos, const vector<move_pos>& best,
+                                       const size_t length)
+    {
+        vector<string> line = {notation(best)};
+        for (const move_pos& turn : best)
+        {
+            move_undo undo;
+            pos.do_move(turn, undo);
+        }
+        pos.pass_turn();
+        unordered_set<uint64_t> seen = {pos.hash};
+        int from, to;
+        while (line.size() < length && logic.hash_move(pos, from, to))
+        {
+            bool found = false;
+            Position next;
+            for_each(pos, [&](const Position& after, const vector<move_pos>& turns) {
+                if (found || Position::square(turns.front().x, turns.front().y) != from ||
+                    Position::square(turns.front().x2, turns.front().y2) != to)
+                    return;
+                found = true;
+                next = after;
+                line.push_back(notation(turns));
+            });
+            if (!found || !seen.insert(next.hash).second)
+                break;
+            pos = next;
+        }
+        return line;
+    }
+
+private:
+    template <class F> void expand(Position& pos, const POS_T x, const POS_T y, F& f, vector<move_pos>& line)
+    {
+        // список ходов уровня хранится в кадре рекурсии
+        const MoveList list = (x == -1 ? Logic::find_turns(pos) : Logic::find_turns(x, y, pos));
+        if (x != -1 && !list.beats)
+        {
+            // серия взятий закончилась
+            finish(pos, f, line);
+            return;
+        }
+        for (const move_pos& turn : list)
+        {
+            move_undo undo;
+            pos.do_move(turn, undo);
+            line.push_back(turn);
+            if (turn.xb == -1)
+                finish(pos, f, line);
+            else
+                expand(pos, turn.x2, turn.y2, f, line);
+            line.pop_back();
+            pos.undo_move(turn, undo);
+        }
+    }
+
+    // Полный ход закончен: ход переходит к сопернику
+    template <class F> void finish(Position& pos, F& f, const vector<move_pos>& line)
+    {
+        pos.pass_turn();
+        f(static_cast<const Position&>(pos), line);
+        pos.pass_turn();
+    }
+
+    // Шаги текущего хода на каждом уровне вложенных вызовов for_each
+    deque<vector<move_pos>> lines;
+    size_t nesting = 0;
+};
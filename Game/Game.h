@@ -9,19 +9,22 @@
 
 #include "../Models/Project_path.h"
 #include "Board.h"
+#include "Bot_search.h"
 #include "Config.h"
 #include "Hand.h"
+#include "Logger.h"
 #include "Logic.h"
+#include "Ponder.h"
 
 class Game
 {
 public:
     Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")),
-             hand(&board), logic(&board, &config)
+             hand(&board), logic(&board, &config),
+             search(&logic, [] { EventDispatcher::wake(); }),
+             ponder(&board, &config)
     {
-        // Создание и очистка журнала ("log.txt")
-        std::ofstream fout(project_path + "log.txt", std::ios_base::trunc); // Открытие файла log.txt и очищение его содержимого
-        fout.close();
+        open_logs(true);                              // Журнал log.txt начинается заново при запуске
     }
 
     // Основная функция запуска игры
@@ -34,6 +37,8 @@ public:
         {
             logic = Logic(&board, &config);           // Создаём новый объект логика
             config.reload();                          // Загружаем новые настройки
+            open_logs(false);                         // Уровень журнала и файл статистики — из новых настроек
+            ponder.reset();                           // Размышление на времени соперника — с новыми настройками
             board.redraw();                           // Перерисовка доски
         }
         else
@@ -50,10 +55,10 @@ public:
         while (++turn_num < Max_turns)
         {
             beat_series = 0;                          // Обнуление серии удачных ударов
-            logic.find_turns(turn_num % 2);           // Поиск всех доступных ходов для текущего игрока
+            turns = logic.find_turns(turn_num % 2);   // Поиск всех доступных ходов для текущего игрока
 
             // Проверка наличия ходов
-            if (logic.turns.empty())                  // Если ходов больше нет, прекращаем игру
+            if (turns.empty())                        // Если ходов больше нет, прекращаем игру
                 break;
 
             // Установка глубины поиска AI исходя из цвета игрока
@@ -77,9 +82,10 @@ public:
                 }
                 else if (resp == Response::BACK)       // Игрок вернул ход обратно
                 {
+                    ponder.stop();                     // Бот размышлял над другой позицией
                     // Проверьте условие отмены хода и выполняйте откат
                     if (config("Bot", std::string("Is") + std::string((1 - turn_num % 2) ? "Black" : "White") + std::string("Bot")) &&
-                        !beat_series && board.history_mtx.size() > 2)
+                        !beat_series && board.history.size() > 1)
                     {
                         board.rollback();              // Отмена предыдущего хода
                         --turn_num;                    // Уменьшаем счётчик ходов
@@ -93,14 +99,45 @@ public:
                 }
             }
             else                                      // Ход компьютера
-                bot_turn(turn_num % 2);               // Передача хода боту
+            {
+                auto resp = bot_turn(turn_num % 2);   // Передача хода боту (окно тем временем отвечает)
+
+                if (resp == Response::QUIT)           // Игрок вышел из игры, пока бот думал
+                {
+                    is_quit = true;
+                    break;
+                }
+                else if (resp == Response::REPLAY)     // Игрок начал игру заново, пока бот думал
+                {
+                    is_replay = true;
+                    break;
+                }
+                else if (resp == Response::BACK)       // Игрок вернул свой последний ход
+                {
+                    board.rollback();                  // Ход соперника бота переигрывается
+                    turn_num -= 2;
+                }
+            }
         }
 
         // Фиксация времени окончания игры
         auto end = std::chrono::steady_clock::now();
-        std::ofstream fout(project_path + "log.txt", std::ios_base::app); // Сохраняем время игры в журнале
-        fout << "Game time: " << static_cast<int>(std::chrono::duration<double, std::milli>(end - start).count()) << " ms\n";
-        fout.close();
+        Logger& log = Logger::instance();             // Сохраняем время игры в журнале
+        log.info("game over", {{"time_ms", static_cast<int>(std::chrono::duration<double, std::milli>(end - start).count())},
+                               {"turns", turn_num}, {"quit", is_quit}, {"replay", is_replay}});
+        if (log.enabled(Logger::Level::Info))
+        {
+            // Запись партии из журнала истории — по moves_per_record ходов в записи, чтобы она поместилась целиком
+            const auto moves = board.history.notation();
+            const size_t moves_per_record = 40;
+            for (size_t first = 0; first < moves.size(); first += moves_per_record)
+            {
+                std::string line;
+                for (size_t i = first; i < std::min(moves.size(), first + moves_per_record); ++i)
+                    line += (line.empty() ? "" : " ") + moves[i];
+                log.info("game moves", {{"from", first + 1}, {"moves", line}});
+            }
+        }
 
         // Логи финала игры
         if (is_replay)                                // Повтор игры
@@ -132,7 +169,7 @@ private:
     {
         // Получаем список доступных ходов для текущего игрока
         std::vector<std::pair<POS_T, POS_T>> cells;
-        for (auto turn : logic.turns)
+        for (auto turn : turns)
         {
             cells.emplace_back(turn.x, turn.y);       // Доступные клетки
         }
@@ -151,7 +188,7 @@ private:
             std::pair<POS_T, POS_T> cell{std::get<1>(resp), std::get<2>(resp)}; // Получены координаты ячейки
 
             bool is_correct = false;                  // Был ли сделан правильный выбор?
-            for (auto turn : logic.turns)
+            for (auto turn : turns)
             {
                 if ((turn.x == cell.first && turn.y == cell.second)) // Проверка начальной точки хода
                 {
@@ -183,7 +220,7 @@ private:
             board.clear_highlight();                  // Удаляем подсветку остальных ходов
             board.set_active(x, y);                   // Активируем выбранную клетку
             std::vector<std::pair<POS_T, POS_T>> cells2;
-            for (auto turn : logic.turns)
+            for (auto turn : turns)
             {
                 if (turn.x == x && turn.y == y)       // Подсветка доступных направлений движения
                 {
@@ -205,14 +242,14 @@ private:
         beat_series = 1;                              // Включаем захватную серию
         while (true)
         {
-            logic.find_turns(pos.x2, pos.y2);         // Найти следующие возможные удары
+            turns = logic.find_turns(pos.x2, pos.y2); // Найти следующие возможные удары
 
             // Если следующий удар невозможен, останавливаемся
-            if (!logic.have_beats)
+            if (!turns.beats)
                 break;
 
             std::vector<std::pair<POS_T, POS_T>> cells;
-            for (auto turn : logic.turns)
+            for (auto turn : turns)
             {
                 cells.emplace_back(turn.x2, turn.y2); // Новые потенциальные ходы
             }
@@ -229,7 +266,7 @@ private:
                 std::pair<POS_T, POS_T> cell{std::get<1>(resp), std::get<2>(resp)}; // Получаем координаты выбранной клетки
 
                 bool is_correct = false;              // Является ли ход правильным?
-                for (auto turn : logic.turns)
+                for (auto turn : turns)
                 {
                     if (turn.x2 == cell.first && turn.y2 == cell.second)
                     {
@@ -252,38 +289,130 @@ private:
     }
 
     // Ход компьютера
-    void bot_turn(const bool color)
+    //
+    // Поиск идёт в отдельном потоке, а главный поток всё это время обрабатывает события окна.
+    // Если игрок выбрал QUIT, REPLAY или BACK, поиск прерывается, начатая серия взятий бота
+    // откатывается, и отклик возвращается в play; иначе возвращается OK.
+    Response bot_turn(const bool color)
     {
         auto start = std::chrono::steady_clock::now(); // Время начала хода
 
-        auto delay_ms = config("Bot", "BotDelayMS");  // Получаем установленную задержку для хода бота
-        std::thread th(std::SDL_Delay, delay_ms);     // Поток ожидания (задержка для визуального эффекта)
-        auto best_turns = logic.find_best_turns(color);// Нахождение лучших ходов для бота
-        th.join();                                    // Синхронизация потока
+        board.present();                              // Показываем ход соперника до начала размышлений
+        Uint32 delay_ms = config("Bot", "BotDelayMS"); // Получаем установленную задержку для хода бота
+        // Ответ, найденный на времени соперника, не требует поиска
+        auto best_turns = ponder.take(Position(board.get_board(), color));
+        const bool ponder_hit = !best_turns.empty();
+        if (!ponder_hit)
+            search.start(color);                      // Нахождение лучших ходов для бота (в пределах MoveTimeMS)
+        // Ждём окончания поиска, но не меньше задержки (для визуального эффекта)
+        auto resp = wait_events(start + std::chrono::milliseconds(delay_ms), !ponder_hit);
+        if (resp != Response::OK)
+        {
+            search.cancel();                          // Ход бота больше не нужен
+            return resp;
+        }
+        if (!ponder_hit)
+            best_turns = search.get();
 
         bool is_first = true;                         // Первый ход в серии
         for (auto turn : best_turns)
         {
             if (!is_first)                            // Пауза между последующими ходами в серии
             {
-                std::SDL_Delay(delay_ms);
+                resp = wait_events(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms), false);
+                if (resp != Response::OK)
+                {
+                    if (resp == Response::BACK)       // Откатываем уже сделанную часть серии
+                        board.rollback();
+                    return resp;
+                }
             }
             is_first = false;
             beat_series += (turn.xb != -1);           // Следим за серией ударов
             board.move_piece(turn, beat_series);      // Осуществление хода
         }
+        board.present();                              // Ход бота выводится одним кадром
 
         auto end = std::chrono::steady_clock::now();  // Время окончания хода
-        std::ofstream fout(project_path + "log.txt", std::ios_base::app); // Добавляем время хода в журнал
-        fout << "Bot turn time: " << static_cast<int>(std::chrono::duration<double, std::milli>(end - start).count()) << " ms\n";
-        fout.close();
+        const int turn_ms = static_cast<int>(std::chrono::duration<double, std::milli>(end - start).count());
+        const auto budget = config("Bot", "MoveTimeMS");
+        if (ponder_hit)                               // Добавляем время хода в журнал
+            Logger::instance().info("bot turn", {{"time_ms", turn_ms}, {"color", int(color)}, {"ponder_hit", true}});
+        else
+            Logger::instance().info("bot turn", {{"time_ms", turn_ms},
+                                                 {"color", int(color)},
+                                                 {"budget_ms", budget.is_number() ? budget.get<int>() : 0},
+                                                 {"depth", logic.stats.depth},
+                                                 {"first_move_cutoffs_pct", logic.stats.first_move_cutoff_percent()},
+                                                 {"tablebase_hits", logic.stats.tablebase_hits},
+                                                 {"book", logic.stats.book}});
+
+        // Подробная статистика поиска — строкой JSON на ход, если задан файл Bot.StatsLog
+        if (!ponder_hit && stats_log.enabled(Logger::Level::Info))
+        {
+            auto line = logic.stats.to_json();
+            line["color"] = int(color);
+            line["level"] = logic.Max_depth;
+            stats_log.info(line.dump());
+        }
+
+        // Пока соперник-человек думает, бот размышляет над его ответами
+        if (config("Bot", "Ponder") == true &&
+            !config("Bot", std::string("Is") + std::string(color ? "White" : "Black") + std::string("Bot")))
+            ponder.start(logic, Position(board.get_board(), !color), logic.Max_depth);
+        return Response::OK;
+    }
+
+    // Обработка событий окна до момента until (и, если for_search, до окончания поиска)
+    //
+    // Возвращает первый отклик игрока, отличный от OK
+    Response wait_events(const std::chrono::steady_clock::time_point until, const bool for_search)
+    {
+        while (true)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const bool searching = for_search && !search.ready();
+            if (!searching && now >= until)
+                break;
+            // Спим до срока, а после него — до конца поиска (поток поиска будит ожидание)
+            const int timeout_ms = now < until ? int(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                         until - now + std::chrono::microseconds(999)).count())
+                                               : -1;
+            auto resp = hand.poll(timeout_ms);
+            if (resp != Response::OK)
+                return resp;
+        }
+        return Response::OK;
     }
 
 private:
+    // Открывает журнал log.txt и файл статистики поиска с параметрами из настроек
+    //
+    // Файлы пишутся потоками журналов, поэтому игровой поток и поиск бота не ждут диска
+    void open_logs(const bool truncate)
+    {
+        const auto level = config("Game", "LogLevel");
+        const auto max_kb = config("Game", "LogMaxKB");
+        const size_t max_bytes = max_kb.is_number() ? max_kb.get<size_t>() * 1024 : 0;
+        Logger::instance().open(project_path + "log.txt",
+                                Logger::parse_level(level.is_string() ? level.get<std::string>() : "info"),
+                                max_bytes, 3, truncate);
+
+        const auto stats_path = config("Bot", "StatsLog");
+        if (stats_path.is_string() && !stats_path.get<std::string>().empty())
+            stats_log.open(project_path + stats_path.get<std::string>(), Logger::Level::Info, max_bytes, 3, false);
+        else
+            stats_log.close();
+    }
+
     Config config;                                   // Объект конфигурации
     Board board;                                     // Объект игровой доски
     Hand hand;                                       // Объект управления игроками
     Logic logic;                                     // Объект логики игры
+    BotSearch search;                                // Поиск хода бота в отдельном потоке
+    Ponder ponder;                                   // Размышление бота на времени соперника
+    Logger stats_log{true};                          // Файл статистики поиска Bot.StatsLog (строки JSON)
     int beat_series;                                 // Количество подряд идущих удачных ударов
+    MoveList turns;                                  // Допустимые ходы (шаги серии) текущего игрока
     bool is_replay = false;                          // Флаг режима повторения игры
 };
\ No newline at end of file
@@ -4,111 +4,135 @@
 #include "../Models/Move.h"
 #include "../Models/Response.h"
 #include "Board.h"
+#include "Event_dispatcher.h"
 
 // Класс для работы с действиями рук пользователей (обработка событий мышью и клавишей)
+//
+// Все ожидания построены на EventDispatcher: пока игрок думает, поток спит и не занимает ядро
 class Hand
 {
 public:
     // Конструктор принимает ссылку на игровую доску
     Hand(Board *board) : board(board)
-    {}
+    {
+        // Изменение размера окна обрабатывается в любом ожидании
+        events.subscribe(SDL_WINDOWEVENT, [board](const SDL_Event &windowEvent) {
+            if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                board->reset_window_size(); // Пересчитываем размеры окна
+            else if (windowEvent.window.event == SDL_WINDOWEVENT_EXPOSED)
+                board->invalidate(); // Окно нужно показать заново
+        });
+        // Содержимое текстур-целей потеряно (например, после сброса графического устройства)
+        events.subscribe(SDL_RENDER_TARGETS_RESET, [board](const SDL_Event &) { board->invalidate(); });
+    }
+
+    // Диспетчер событий, к которому другие подсистемы добавляют свои обработчики и тики
+    EventDispatcher &dispatcher()
+    {
+        return events;
+    }
 
     // Метод получает событие нажатия клавиши мыши и возвращает соответствующий отклик
-    tuple<Response, POS_T, POS_T> get_cell() const
+    tuple<Response, POS_T, POS_T> get_cell()
     {
         SDL_Event windowEvent; // Экземпляр события SDL
         Response resp = Response::OK; // Изначально считаем ответ успешным
-        int x = -1, y = -1; // Хранятся координаты мыши
         int xc = -1, yc = -1; // Внутренние координаты клетки на доске
 
-        // Цикл опроса событий оконной системы
-        while (true)
+        // Ждём события, пока не получим отклик
+        while (resp == Response::OK)
         {
-            if (SDL_PollEvent(&windowEvent)) // Если произошло какое-нибудь событие
+            board->present(); // Перед сном выводим накопленные изменения одним кадром
+            if (!events.wait(windowEvent)) // Ожидание прервано без события
+                continue;
+            switch (windowEvent.type) // Обрабатываем разные типы событий
             {
-                switch (windowEvent.type) // Обрабатываем разные типы событий
-                {
-                case SDL_QUIT: // Нажата кнопка закрытия окна
-                    resp = Response::QUIT; // Выставляем команду выхода
-                    break;
+            case SDL_QUIT: // Нажата кнопка закрытия окна
+                resp = Response::QUIT; // Выставляем команду выхода
+                break;
 
-                case SDL_MOUSEBUTTONDOWN: // Нажата кнопка мыши
-                    x = windowEvent.motion.x; // Забираем координату X
-                    y = windowEvent.motion.y; // Забираем координату Y
-                    xc = int(y / (board->H / 10) - 1); // Переводим пиксельные координаты в индексы доски
-                    yc = int(x / (board->W / 10) - 1);
-
-                    // Проверяем, какая область была нажата
-                    if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
-                    {
-                        resp = Response::BACK; // Команда отступления (вернуться назад)
-                    }
-                    else if (xc == -1 && yc == 8)
-                    {
-                        resp = Response::REPLAY; // Команда перезапуска игры
-                    }
-                    else if (xc >= 0 && xc < 8 && yc >= 0 && yc < 8)
-                    {
-                        resp = Response::CELL; // Пользователь указал клетку на доске
-                    }
-                    else
-                    {
-                        xc = -1; // Инвалидные координаты
-                        yc = -1;
-                    }
-                    break;
-
-                case SDL_WINDOWEVENT: // Изменился размер окна
-                    if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-                    {
-                        board->reset_window_size(); // Пересчитываем размеры окна
-                        break;
-                    }
-                }
-                if (resp != Response::OK) // Если возникла любая реакция кроме OK, прерываем цикл
-                    break;
+            case SDL_MOUSEBUTTONDOWN: // Нажата кнопка мыши
+                resp = click(windowEvent.motion.x, windowEvent.motion.y, xc, yc); // Определяем нажатую область
+                break;
             }
         }
         return {resp, xc, yc}; // Возвращаем отклик и координаты клетки
     }
 
     // Метод ожидает пользовательского ввода и интерпретирует его
-    Response wait() const
+    Response wait()
     {
         SDL_Event windowEvent; // Объект события SDL
         Response resp = Response::OK; // Первоначально устанавливаем успех
 
-        // Цикл опроса событий оконной системы
-        while (true)
+        // Ждём события, пока игрок не выберет выход или новую игру
+        while (resp == Response::OK)
         {
-            if (SDL_PollEvent(&windowEvent)) // Произошло событие
+            board->present(); // Перед сном выводим накопленные изменения одним кадром
+            if (!events.wait(windowEvent)) // Ожидание прервано без события
+                continue;
+            switch (windowEvent.type) // Обрабатываем разные типы событий
             {
-                switch (windowEvent.type) // Обрабатываем разные типы событий
-                {
-                case SDL_QUIT: // Нажата кнопка закрытия окна
-                    resp = Response::QUIT; // Сообщаем о завершении игры
-                    break;
-
-                case SDL_WINDOWEVENT_SIZE_CHANGED: // Изменилась ширина окна
-                    board->reset_window_size(); // Нужно обновить размеры окна
-                    break;
+            case SDL_QUIT: // Нажата кнопка закрытия окна
+                resp = Response::QUIT; // Сообщаем о завершении игры
+                break;
 
-                case SDL_MOUSEBUTTONDOWN: // Нажата кнопка мыши
-                    int x = windowEvent.motion.x; // Получаем координаты клика
-                    int y = windowEvent.motion.y;
-                    int xc = int(y / (board->H / 10) - 1); // Приводим к индексам доски
-                    int yc = int(x / (board->W / 10) - 1);
-                    if (xc == -1 && yc == 8)
-                        resp = Response::REPLAY; // Переключение на перезапуск игры
-                    break;
-                }
-                if (resp != Response::OK) // Если произошел какой-то иной отклик, выходим из цикла
-                    break;
+            case SDL_MOUSEBUTTONDOWN: // Нажата кнопка мыши
+                int xc, yc;
+                if (click(windowEvent.motion.x, windowEvent.motion.y, xc, yc) == Response::REPLAY)
+                    resp = Response::REPLAY; // Переключение на перезапуск игры
+                break;
             }
         }
         return resp; // Возвращаем полученный отклик
     }
 
+    // Метод обрабатывает события окна, пока бот думает: ждёт не дольше timeout_ms (-1 — без ограничения)
+    // или до пробуждения через EventDispatcher::wake
+    //
+    // Возвращает QUIT, REPLAY или BACK, если игрок выбрал одно из этих действий, иначе OK
+    // (нажатия на клетки доски в это время игнорируются)
+    Response poll(const int timeout_ms)
+    {
+        SDL_Event windowEvent; // Экземпляр события SDL
+        board->present(); // Перед сном выводим накопленные изменения одним кадром
+        // Ждём первое событие, затем разбираем уже накопившиеся, не засыпая снова
+        for (bool got = events.wait(windowEvent, timeout_ms); got; got = events.wait(windowEvent, 0))
+        {
+            int xc = -1, yc = -1; // Внутренние координаты клетки на доске
+            Response resp = Response::OK;
+            switch (windowEvent.type)
+            {
+            case SDL_QUIT: // Нажата кнопка закрытия окна
+                return Response::QUIT;
+
+            case SDL_MOUSEBUTTONDOWN: // Нажата кнопка мыши
+                resp = click(windowEvent.motion.x, windowEvent.motion.y, xc, yc);
+                if (resp != Response::CELL && resp != Response::OK)
+                    return resp;
+                break;
+            }
+        }
+        return Response::OK;
+    }
+
 private:
+    // Переводит координаты нажатия в отклик: BACK, REPLAY, CELL (клетка в xc, yc) или OK (мимо)
+    Response click(const int x, const int y, int &xc, int &yc) const
+    {
+        xc = int(y / (board->H / 10) - 1); // Переводим пиксельные координаты в индексы доски
+        yc = int(x / (board->W / 10) - 1);
+        if (xc == -1 && yc == -1 && !board->history.empty())
+            return Response::BACK; // Команда отступления (вернуться назад)
+        if (xc == -1 && yc == 8)
+            return Response::REPLAY; // Команда перезапуска игры
+        if (xc >= 0 && xc < 8 && yc >= 0 && yc < 8)
+            return Response::CELL; // Пользователь указал клетку на доске
+        xc = -1; // Инвалидные координаты
+        yc = -1;
+        return Response::OK;
+    }
+
     Board *board; // Указатель  на игровую доску
-};
\ No newline at end of file
+    EventDispatcher events; // Ожидание событий окна
+};
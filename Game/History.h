@@ -0,0 +1,174 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Один шаг хода в истории партии (серия взятий записывается шагом на каждое взятие)
+struct history_step
+{
+    int8_t from = -1;          // Клетка, с которой пошла фигура (номер Position::square)
+    int8_t to = -1;            // Клетка, на которую она встала
+    int8_t captured = -1;      // Клетка сбитой фигуры (-1 — ход без взятия)
+    uint8_t captured_piece = 0; // Код сбитой фигуры (1–4), чтобы вернуть её при откате
+    uint8_t promoted = 0;      // Шашка стала дамкой на этом шаге
+    uint8_t beat_series = 0;   // Номер взятия в серии (0 — тихий ход)
+};
+
+// История партии: начальная доска и журнал шагов с опорными снимками доски
+//
+// Шаг занимает 6 байт вместо копии матрицы 8x8; откат последнего шага — обратное применение
+// записи за O(1). Каждые keyframe_interval шагов сохраняется снимок 32 тёмных клеток, поэтому доска
+// после любого шага восстанавливается не более чем за keyframe_interval применений (просмотр партии).
+// Журнал ограничен max_steps шагами: самые старые шаги отбрасываются блоками до ближайшего снимка.
+class History
+{
+public:
+    static constexpr size_t keyframe_interval = 32;
+    static constexpr size_t max_steps = 1 << 16;
+
+    // Начинает историю с доски board
+    void reset(const vector<vector<POS_T>>& board)
+    {
+        steps.clear();
+        keyframes.clear();
+        keyframes.push_back(pack(board));
+        dropped = 0;
+    }
+
+    // Добавляет шаг; board — доска после него
+    void push(const history_step& step, const vector<vector<POS_T>>& board)
+    {
+        steps.push_back(step);
+        if (steps.size() % keyframe_interval == 0)
+            keyframes.push_back(pack(board));
+        if (steps.size() > max_steps)
+        {
+            // отбрасываем самый старый блок: его конечный снимок становится началом истории
+            steps.erase(steps.begin(), steps.begin() + keyframe_interval);
+            keyframes.pop_front();
+            dropped += keyframe_interval;
+        }
+    }
+
+    // Убирает последний шаг из журнала и возвращает его (для отката доски через revert)
+    history_step pop()
+    {
+        const history_step step = steps.back();
+        if (steps.size() % keyframe_interval == 0)
+            keyframes.pop_back(); // снимок после этого шага больше не нужен
+        steps.pop_back();
+        return step;
+    }
+
+    // Число шагов в журнале
+    size_t size() const
+    {
+        return steps.size();
+    }
+
+    bool empty() const
+    {
+        return steps.empty();
+    }
+
+    const history_step& back() const
+    {
+        return steps.back();
+    }
+
+    const history_step& operator[](const size_t i) const
+    {
+        return steps[i];
+    }
+
+    // Доска после первых n шагов журнала (0 — начало истории)
+    vector<vector<POS_T>> board_at(const size_t n) const
+    {
+        vector<vector<POS_T>> board = unpack(keyframes[n / keyframe_interval]);
+        for (size_t i = n / keyframe_interval * keyframe_interval; i < n; ++i)
+            apply(steps[i], board);
+        return board;
+    }
+
+    // Запись партии: полные ходы в обозначениях "c3-d4" и "c3:e5:g3" (для журнала и выгрузки)
+    vector<string> notation() const
+    {
+        vector<string> moves;
+        for (const history_step& step : steps)
+        {
+            if (step.beat_series > 1 && !moves.empty()) // продолжение серии взятий
+            {
+                moves.back() += ":" + Position::square_name(step.to);
+                continue;
+            }
+            moves.push_back(Position::square_name(step.from) + (step.captured == -1 ? "-" : ":") +
+                            Position::square_name(step.to));
+        }
+        return moves;
+    }
+
+    // Число шагов, отброшенных из начала журнала из-за ограничения длины
+    size_t dropped_steps() const
+    {
+        return dropped;
+    }
+
+    // Применяет шаг к доске
+    static void apply(const history_step& step, vector<vector<POS_T>>& board)
+    {
+        POS_T& from = cell(board, step.from);
+        if (step.captured != -1)
+            cell(board, step.captured) = 0;
+        cell(board, step.to) = POS_T(from + (step.promoted ? 2 : 0));
+        from = 0;
+    }
+
+    // Отменяет шаг на доске (доска должна быть в состоянии сразу после него)
+    static void revert(const history_step& step, vector<vector<POS_T>>& board)
+    {
+        POS_T& to = cell(board, step.to);
+        cell(board, step.from) = POS_T(to - (step.promoted ? 2 : 0));
+        to = 0;
+        if (step.captured != -1)
+            cell(board, step.captured) = POS_T(step.captured_piece);
+    }
+
+private:
+    using snapshot = array<uint8_t, 32>;
+
+    static POS_T& cell(vector<vector<POS_T>>& board, const int sq)
+    {
+        return board[Position::row(sq)][Position::col(sq)];
+    }
+
+    // Снимок доски: коды фигур на 32 тёмных клетках
+    static snapshot pack(const vector<vector<POS_T>>& board)
+    {
+        snapshot result;
+        for (int sq = 0; sq < 32; ++sq)
+            result[sq] = uint8_t(board[Position::row(sq)][Position::col(sq)]);
+        return result;
+    }
+
+    static vector<vector<POS_T>> unpack(const snapshot& packed)
+    {
+        vector<vector<POS_T>> board(8, vector<POS_T>(8, 0));
+        for (int sq = 0; sq < 32; ++sq)
+            cell(board, sq) = POS_T(packed[sq]);
+        return board;
+    }
+
+    // Журнал шагов
+    deque<history_step> steps;
+    // Снимки доски: keyframes[k] — доска после k * keyframe_interval шагов журнала
+    deque<snapshot> keyframes;
+    // Сколько шагов отброшено из начала
+    size_t dropped = 0;
+};
@@ -0,0 +1,457 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+using namespace std;
+
+// Асинхронный журнал: записи кладутся в кольцевой буфер без блокировок, файл пишет фоновый поток
+//
+// Запись из любого потока — копирование сообщения и полей в ячейку буфера (сотни наносекунд);
+// форматирование, запись на диск и ротация файлов происходят в потоке журнала. Если буфер полон,
+// запись отбрасывается (считается в dropped()), и вызывающий поток никогда не ждёт диска.
+// Буфер — ограниченная очередь Вьюкова: производители занимают ячейки через CAS, читатель один.
+class Logger
+{
+public:
+    enum class Level : uint8_t
+    {
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Off
+    };
+
+    // Поле записи "ключ=значение"; ключ — строковый литерал (хранится указатель), значение копируется
+    struct Field
+    {
+        enum class Kind : uint8_t
+        {
+            Int,
+            Double,
+            Bool,
+            Text
+        };
+
+        template <class T, typename enable_if<is_integral<T>::value && !is_same<T, bool>::value, int>::type = 0>
+        Field(const char* key, const T value) : key(key), kind(Kind::Int), i(int64_t(value))
+        {}
+        Field(const char* key, const double value) : key(key), kind(Kind::Double), d(value)
+        {}
+        Field(const char* key, const bool value) : key(key), kind(Kind::Bool), b(value)
+        {}
+        Field(const char* key, const char* value) : key(key), kind(Kind::Text), text(value), len(strlen(value))
+        {}
+        Field(const char* key, const string& value) : key(key), kind(Kind::Text), text(value.data()), len(value.size())
+        {}
+
+        const char* key;
+        Kind kind;
+        union
+        {
+            int64_t i;
+            double d;
+            bool b;
+        };
+        const char* text = nullptr;
+        size_t len = 0;
+    };
+
+    static constexpr size_t max_fields = 8;   // Поля сверх этого числа отбрасываются
+    static constexpr size_t text_size = 512;  // Место под сообщение и текстовые поля одной записи
+
+    // plain — писать только текст сообщения, без времени, уровня и полей (например, строки JSON)
+    explicit Logger(const bool plain = false, const size_t capacity = 1024) : plain(plain)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        mask = size - 1;
+        cells.reset(new cell[size]);
+        for (size_t i = 0; i < size; ++i)
+            cells[i].sequence.store(i, memory_order_relaxed);
+    }
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    ~Logger()
+    {
+        close();
+    }
+
+    // Журнал игры (log.txt); настраивается и открывается в Game
+    static Logger& instance()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    // Открывает файл path и запускает поток журнала
+    //
+    // Параметры:
+    // - level: записи ниже этого уровня отбрасываются сразу в вызывающем потоке
+    // - max_bytes: при превышении размера файл переименовывается в path.1 (path.1 — в path.2 и т.д.),
+    //   и запись продолжается в новый файл; 0 — без ротации
+    // - max_files: сколько старых файлов хранить
+    // - truncate: очистить файл при открытии, иначе дописывать в конец
+    void open(const string& path, const Level level = Level::Info, const size_t max_bytes = 0,
+              const unsigned max_files = 3, const bool truncate = true)
+    {
+        close();
+        file_path = path;
+        rotate_bytes = max_bytes;
+        rotate_files = max_files;
+        fout.open(file_path, truncate ? ios_base::trunc : ios_base::app);
+        written = truncate ? 0 : size_t(max<streamoff>(0, streamoff(fout.tellp())));
+        stop = false;
+        worker = thread([this]() { drain_loop(); });
+        min_level.store(level, memory_order_release);
+    }
+
+    // Дописывает всё из буфера и останавливает поток журнала; дальнейшие записи отбрасываются
+    void close()
+    {
+        min_level.store(Level::Off, memory_order_release);
+        if (!worker.joinable())
+            return;
+        {
+            lock_guard<mutex> lock(wake_mutex);
+            stop = true;
+        }
+        wake.notify_one();
+        worker.join();
+        fout.close();
+    }
+
+    void set_level(const Level level)
+    {
+        if (worker.joinable())
+            min_level.store(level, memory_order_release);
+    }
+
+    // Уровень по названию из настроек: "debug", "info", "warning", "error" или "off"
+    static Level parse_level(const string& name)
+    {
+        if (name == "debug")
+            return Level::Debug;
+        if (name == "warning")
+            return Level::Warning;
+        if (name == "error")
+            return Level::Error;
+        if (name == "off")
+            return Level::Off;
+        return Level::Info;
+    }
+
+    // Будет ли записана запись уровня level (чтобы не собирать поля зря)
+    bool enabled(const Level level) const
+    {
+        return level >= min_level.load(memory_order_relaxed) && level != Level::Off;
+    }
+
+    // Кладёт запись в буфер; false — запись отброшена (уровень ниже порога, журнал закрыт или буфер полон)
+    bool write(const Level level, const char* message, const initializer_list<Field> fields = {})
+    {
+        return write(level, message, strlen(message), fields);
+    }
+    bool write(const Level level, const string& message, const initializer_list<Field> fields = {})
+    {
+        return write(level, message.data(), message.size(), fields);
+    }
+
+    template <class Message> bool debug(const Message& message, const initializer_list<Field> fields = {})
+    {
+        return write(Level::Debug, message, fields);
+    }
+    template <class Message> bool info(const Message& message, const initializer_list<Field> fields = {})
+    {
+        return write(Level::Info, message, fields);
+    }
+    template <class Message> bool warning(const Message& message, const initializer_list<Field> fields = {})
+    {
+        return write(Level::Warning, message, fields);
+    }
+    template <class Message> bool error(const Message& message, const initializer_list<Field> fields = {})
+    {
+        return write(Level::Error, message, fields);
+    }
+
+    // Дожидается, пока поток журнала запишет в файл всё, что было в буфере на момент вызова
+    void flush()
+    {
+        if (!worker.joinable())
+            return;
+        const size_t target = enqueue_pos.load(memory_order_acquire);
+        {
+            lock_guard<mutex> lock(wake_mutex); // иначе пробуждение может потеряться между проверкой и сном
+            flush_requested.store(true, memory_order_release);
+        }
+        wake.notify_one();
+        while (flushed_pos.load(memory_order_acquire) < target)
+            this_thread::sleep_for(chrono::microseconds(200));
+    }
+
+    // Число записей, отброшенных из-за переполнения буфера
+    uint64_t dropped() const
+    {
+        return dropped_count.load(memory_order_relaxed);
+    }
+
+private:
+    struct record
+    {
+        int64_t time_us;               // Время записи (system_clock, микросекунды)
+        Level level;
+        uint8_t nfields;
+        uint16_t message_len;          // Сообщение — первые message_len байт text
+        struct
+        {
+            const char* key;
+            Field::Kind kind;
+            uint16_t offset, len;      // Текстовое значение — text[offset, offset + len)
+            union
+            {
+                int64_t i;
+                double d;
+                bool b;
+            };
+        } fields[max_fields];
+        char text[text_size];
+    };
+
+    struct alignas(64) cell
+    {
+        atomic<size_t> sequence;
+        record data;
+    };
+
+    bool write(const Level level, const char* message, const size_t message_len,
+               const initializer_list<Field>& fields)
+    {
+        if (!enabled(level))
+            return false;
+        // занимаем ячейку: её номер последовательности равен позиции, если предыдущий круг уже прочитан
+        size_t pos = enqueue_pos.load(memory_order_relaxed);
+        cell* c;
+        while (true)
+        {
+            c = &cells[pos & mask];
+            const size_t seq = c->sequence.load(memory_order_acquire);
+            const intptr_t dif = intptr_t(seq) - intptr_t(pos);
+            if (dif == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                dropped_count.fetch_add(1, memory_order_relaxed); // буфер полон
+                return false;
+            }
+            else
+                pos = enqueue_pos.load(memory_order_relaxed);
+        }
+
+        record& r = c->data;
+        r.time_us = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch())
+                        .count();
+        r.level = level;
+        size_t used = min(message_len, text_size);
+        memcpy(r.text, message, used);
+        r.message_len = uint16_t(used);
+        r.nfields = 0;
+        for (const Field& f : fields)
+        {
+            if (r.nfields == max_fields)
+                break;
+            auto& out = r.fields[r.nfields++];
+            out.key = f.key;
+            out.kind = f.kind;
+            switch (f.kind)
+            {
+            case Field::Kind::Int:
+                out.i = f.i;
+                break;
+            case Field::Kind::Double:
+                out.d = f.d;
+                break;
+            case Field::Kind::Bool:
+                out.b = f.b;
+                break;
+            case Field::Kind::Text:
+                out.offset = uint16_t(used);
+                out.len = uint16_t(min(f.len, text_size - used)); // не влезшее обрезается
+                memcpy(r.text + used, f.text, out.len);
+                used += out.len;
+                break;
+            }
+        }
+        // запись готова для потока журнала; его будим, только если он уснул на пустом буфере, поэтому
+        // пока записи идут потоком, мьютекс не трогается. Последовательная согласованность этой пары
+        // операций и пары в drain_loop гарантирует: либо мы видим sleeping, либо он перед сном видит запись.
+        c->sequence.store(pos + 1, memory_order_seq_cst);
+        if (sleeping.load(memory_order_seq_cst))
+        {
+            {
+                lock_guard<mutex> lock(wake_mutex);
+                sleeping.store(false, memory_order_relaxed);
+            }
+            wake.notify_one();
+        }
+        return true;
+    }
+
+    // Поток журнала: разбирает буфер, а когда он пуст — сбрасывает файл и засыпает
+    void drain_loop()
+    {
+        string line;
+        while (true)
+        {
+            bool any = false;
+            while (true)
+            {
+                cell& c = cells[dequeue_pos & mask];
+                if (c.sequence.load(memory_order_acquire) != dequeue_pos + 1)
+                    break; // ячейка ещё не заполнена
+                line.clear();
+                format(c.data, line);
+                c.sequence.store(dequeue_pos + mask + 1, memory_order_release); // ячейка свободна для следующего круга
+                ++dequeue_pos;
+                write_line(line);
+                any = true;
+            }
+            if (any || flush_requested.exchange(false, memory_order_acq_rel))
+            {
+                fout.flush();
+                flushed_pos.store(dequeue_pos, memory_order_release);
+            }
+            unique_lock<mutex> lock(wake_mutex);
+            if (stop && cells[dequeue_pos & mask].sequence.load(memory_order_acquire) != dequeue_pos + 1)
+                break;
+            if (any)
+                continue;
+            // буфер пуст: объявляем сон и проверяем буфер ещё раз (запись могла появиться до объявления)
+            sleeping.store(true, memory_order_seq_cst);
+            if (cells[dequeue_pos & mask].sequence.load(memory_order_seq_cst) == dequeue_pos + 1)
+            {
+                sleeping.store(false, memory_order_relaxed);
+                continue;
+            }
+            // спим без таймаута до записи, flush или close: без записей поток не тратит процессор
+            wake.wait(lock, [this]() {
+                return stop || !sleeping.load(memory_order_relaxed) || flush_requested.load(memory_order_acquire);
+            });
+            sleeping.store(false, memory_order_relaxed);
+        }
+    }
+
+    void format(const record& r, string& line) const
+    {
+        if (plain)
+        {
+            line.append(r.text, r.message_len);
+            line += '\n';
+            return;
+        }
+        static const char* const level_names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+        char buf[64];
+        const time_t seconds = time_t(r.time_us / 1000000);
+        const tm* local = localtime(&seconds); // вызывается только из потока журнала
+        const size_t n = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", local);
+        snprintf(buf + n, sizeof(buf) - n, ".%03d ", int(r.time_us / 1000 % 1000));
+        line += buf;
+        line += level_names[size_t(r.level)];
+        line += ' ';
+        line.append(r.text, r.message_len);
+        for (size_t i = 0; i < r.nfields; ++i)
+        {
+            const auto& f = r.fields[i];
+            line += ' ';
+            line += f.key;
+            line += '=';
+            switch (f.kind)
+            {
+            case Field::Kind::Int:
+                line += to_string(f.i);
+                break;
+            case Field::Kind::Double:
+                snprintf(buf, sizeof(buf), "%g", f.d);
+                line += buf;
+                break;
+            case Field::Kind::Bool:
+                line += f.b ? "true" : "false";
+                break;
+            case Field::Kind::Text:
+            {
+                const bool quote = memchr(r.text + f.offset, ' ', f.len) != nullptr || f.len == 0;
+                if (quote)
+                    line += '"';
+                line.append(r.text + f.offset, f.len);
+                if (quote)
+                    line += '"';
+                break;
+            }
+            }
+        }
+        line += '\n';
+    }
+
+    void write_line(const string& line)
+    {
+        fout.write(line.data(), streamsize(line.size()));
+        written += line.size();
+        if (rotate_bytes && written >= rotate_bytes)
+            rotate();
+    }
+
+    // Сдвигает старые файлы (path.1 -> path.2, ...) и начинает path заново
+    void rotate()
+    {
+        fout.close();
+        if (rotate_files == 0)
+            remove(file_path.c_str());
+        else
+        {
+            remove((file_path + "." + to_string(rotate_files)).c_str());
+            for (unsigned i = rotate_files; i > 1; --i)
+                rename((file_path + "." + to_string(i - 1)).c_str(), (file_path + "." + to_string(i)).c_str());
+            rename(file_path.c_str(), (file_path + ".1").c_str());
+        }
+        fout.open(file_path, ios_base::trunc);
+        written = 0;
+    }
+
+    const bool plain;
+    unique_ptr<cell[]> cells;
+    size_t mask = 0;
+    alignas(64) atomic<size_t> enqueue_pos{0};  // Следующая ячейка для производителей
+    alignas(64) size_t dequeue_pos = 0;         // Следующая ячейка для потока журнала
+    atomic<size_t> flushed_pos{0};             // Все записи до этой позиции сброшены в файл
+    atomic<bool> flush_requested{false};
+    atomic<Level> min_level{Level::Off};        // Off — журнал закрыт
+    atomic<uint64_t> dropped_count{0};
+
+    thread worker;
+    mutex wake_mutex;
+    condition_variable wake;
+    bool stop = false;
+    atomic<bool> sleeping{false}; // Поток журнала спит на пустом буфере и ждёт пробуждения от производителя
+
+    ofstream fout;
+    string file_path;
+    size_t rotate_bytes = 0;
+    unsigned rotate_files = 3;
+    size_t written = 0;
+};
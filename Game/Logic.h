@@ -1,46 +1,437 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <memory>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include "../Models/Alloc_counter.h"
 #include "../Models/Move.h"
-#include "Board.h"
+#include "../Models/Move_list.h"
+#include "../Models/Move_tables.h"
+#include "../Models/Position.h"
+#include "../Models/Search_stats.h"
+#include "Board_state.h"
 #include "Config.h"
+#include "Opening_book.h"
+#include "Tablebase.h"
+#include "Transposition_table.h"
 
 using namespace std;
 
 const int INF = 1e9; // Константа бесконечности для оценочной функции
 
+// Полуширина окна аспирации в корне (в единицах Logic::to_value: 0.1 — около 10% соотношения сил);
+// при выходе оценки за окно оно расширяется вчетверо, а шире max_aspiration_window становится полным
+const double aspiration_window = 0.1;
+const double max_aspiration_window = 2;
+
+// Предел значения таблицы истории: сильно ниже приоритетов хода из таблицы, взятий и ходов-убийц
+// в упорядочивании ходов, поэтому тихий ход по истории их не обгоняет, и int не переполняется
+const int max_history = 1 << 20;
+
+// Способ оценки позиции (BotScoringType)
+enum class Scoring
+{
+    NumberOnly,        // Только количество фигур
+    NumberAndPotential // Количество фигур и продвижение шашек
+};
+
+// Режим отсечений (Optimization)
+enum class Pruning
+{
+    O0, // Полный перебор без отсечений
+    O1, // Альфа-бета отсечения
+    O2
+};
+
 class Logic
 {
 public:
     // Конструктор класса Logic
     //
     // Параметры:
-    // - board: ссылка на игровую доску
+    // - board: ссылка на игровую доску (окно для поиска не нужно, достаточно состояния доски)
     // - config: ссылка на объект конфигурации
-    Logic(Board* board, Config* config) : board(board), config(config)
+    Logic(BoardState* board, Config* config) : board(board), config(config)
     {
         // Инициализация генератора случайных чисел
         // Если NoRandom выключено, используем текущее время как seed
-        rand_eng = std::default_random_engine(
-            !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0);
+        no_random = (*config)("Bot", "NoRandom") == true;
+        seed = !no_random ? unsigned(time(0)) : 0;
+        rand_eng = std::default_random_engine(seed);
         // Инициализация способа расчета очков и опции оптимизации
-        scoring_mode = (*config)("Bot", "BotScoringType");
-        optimization = (*config)("Bot", "Optimization");
+        // (строки настроек переводятся в перечисления один раз, а не в каждом узле поиска;
+        // нет в файле настроек — NumberOnly и O1, NoRandom выключено)
+        scoring_mode = (*config)("Bot", "BotScoringType") == "NumberAndPotential" ? Scoring::NumberAndPotential
+                                                                                   : Scoring::NumberOnly;
+        const auto optimization_name = (*config)("Bot", "Optimization");
+        optimization = optimization_name == "O0" ? Pruning::O0 : optimization_name == "O2" ? Pruning::O2 : Pruning::O1;
+        // Продление взятий за горизонтом (по умолчанию включено)
+        quiescence = (*config)("Bot", "Quiescence") != false;
+        tt_salt = evaluation_salt();
+        // Размер таблицы транспозиций в мегабайтах (нет в файле настроек — без таблицы)
+        const auto hash_mb = (*config)("Bot", "HashMB");
+        tt = make_shared<TranspositionTable>(hash_mb.is_number() ? hash_mb.get<size_t>() : 0);
+        // Бюджет времени на ход (0 или нет в файле настроек — поиск на фиксированную глубину)
+        const auto move_time = (*config)("Bot", "MoveTimeMS");
+        move_time_ms = move_time.is_number() ? move_time.get<unsigned int>() : 0;
+        // Число потоков поиска (0 — по числу ядер, нет в файле настроек — один поток)
+        const auto thread_count = (*config)("Bot", "Threads");
+        threads = thread_count.is_number() ? thread_count.get<unsigned>() : 1;
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        abort_search = make_shared<atomic<bool>>(false);
+        cancelled = make_shared<atomic<bool>>(false);
+        // Эндшпильная база (пустой путь — без базы); если файл не открылся, играем без неё
+        const auto tablebase_path = (*config)("Bot", "TablebasePath");
+        if (tablebase_path.is_string() && !tablebase_path.get<string>().empty())
+        {
+            tablebase = make_shared<Tablebase>();
+            if (!tablebase->open(project_path + tablebase_path.get<string>()))
+                tablebase.reset();
+        }
+        // Дебютная книга от checkers_bookgen (пустой путь — без книги)
+        const auto book_path = (*config)("Bot", "BookPath");
+        if (book_path.is_string() && !book_path.get<string>().empty())
+        {
+            book = make_shared<OpeningBook>();
+            if (!book->load(project_path + book_path.get<string>()))
+                book.reset();
+        }
     }
 
     // Основная функция поиска лучшего хода
     //
+    // При заданном MoveTimeMS глубина увеличивается на единицу за итерацию (не больше Max_depth),
+    // пока не закончится бюджет времени; результатом остаётся последняя завершённая итерация.
+    // Без бюджета выполняется одна итерация сразу на глубину Max_depth.
+    //
+    // При Threads > 1 параллельно работают вспомогательные потоки (Lazy SMP): они ищут из того же корня
+    // со сдвигом глубины и своим порядком ходов, наполняя общую таблицу транспозиций.
+    // Берётся линия самой глубокой завершённой итерации среди всех потоков.
+    //
     // Параметры:
     // - color: цвет текущего игрока (0 — белые, 1 — чёрные)
     // Возвращаемый результат:
     // последовательность оптимальных ходов
     vector<move_pos> find_best_turns(const bool color) {
-        next_best_state.clear(); // очистка списка состояний переходов
-        next_move.clear();       // очистка последовательности ходов
+        // доска переводится в битовые маски один раз
+        return find_best_turns(Position(board->get_board(), color));
+    }
 
-        // запускаем рекурсию для поиска первого лучшего хода
-        find_first_best_turn(board->get_board(), color, -1, -1, 0);
+    // Поиск лучшего хода из заданной позиции (ходит игрок root.color), доска не читается:
+    // так можно искать в фоне, пока главный поток меняет доску (размышление на времени соперника)
+    vector<move_pos> find_best_turns(const Position& root) {
+        const size_t allocs_before = alloc_count();
+        const auto start = chrono::steady_clock::now();
+        deadline = start + chrono::milliseconds(move_time_ms);
+        stats = SearchStats();
+        tt->new_search();
+        abort_search->store(false);
+
+        pos = root;
+        root_turns = find_turns(pos); // ходы из корня общие для всех итераций
+        if (!no_random) // равноценные ходы в корне выбираются случайно
+            std::shuffle(root_turns.begin(), root_turns.end(), rand_eng);
+
+        vector<move_pos> best_turns;
+        // пока партия в книге, ход берётся из неё без поиска
+        stats.book = book && book_move(best_turns);
+        if (stats.book) {
+            stats.time_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            return best_turns;
+        }
+        // позиция из эндшпильной базы: все позиции после ходов тоже в базе,
+        // поэтому одной итерации достаточно для точного выбора хода
+        uint8_t root_value;
+        const bool root_in_tablebase = tablebase && tablebase->probe(pos, root_value);
+        if (root_turns.empty())
+            return best_turns; // ходов нет, искать нечего
+
+        // запускаем вспомогательные потоки
+        const int first_depth = (move_time_ms ? 0 : Max_depth);
+        while (helpers.size() + 1 < threads)
+            helpers.push_back(Logic(*this, unsigned(helpers.size() + 1)));
+        vector<thread> pool;
+        for (size_t i = 0; i + 1 < threads; ++i) {
+            Logic& helper = helpers[i];
+            helper.Max_depth = Max_depth;
+            helper.pos = pos;
+            helper.root_turns = root_turns;
+            // по времени половина помощников начинает на одну итерацию глубже основного потока;
+            // на фиксированной глубине помощники начинают на одну-две итерации мельче и углубляются до неё,
+            // чтобы потоки не шли одной глубиной
+            const int helper_depth = move_time_ms ? min(first_depth + int((i + 1) % 2), Max_depth)
+                                                  : max(Max_depth - 1 - int(i % 2), 0);
+            pool.emplace_back(&Logic::helper_search, &helper, helper_depth);
+        }
+
+        prepare_search();
+        for (search_depth = first_depth; search_depth <= Max_depth; ++search_depth) {
+            // первая итерация всегда доводится до конца, чтобы у бота был ход
+            timed = (move_time_ms != 0 && search_depth > first_depth);
+            auto line = search_root();
+            if (stop)
+                break; // прерванная итерация не используется
+            best_turns = line;
+            stats.depth = search_depth;
+            stats.score = root_score;
+            // лучший ход прошлой итерации просматривается первым
+            auto best = std::find(root_turns.begin(), root_turns.end(), best_turns.front());
+            std::rotate(root_turns.begin(), best, best + 1);
+            // следующая итерация обычно дольше всех предыдущих вместе взятых:
+            // не начинаем её, если уже потрачена половина бюджета
+            if (root_in_tablebase ||
+                (move_time_ms && (chrono::steady_clock::now() - start) * 2 >= chrono::milliseconds(move_time_ms)))
+                break;
+        }
+
+        // останавливаем помощников и берём самую глубокую завершённую линию
+        abort_search->store(true);
+        for (auto& th : pool)
+            th.join();
+        for (size_t i = 0; i < pool.size(); ++i) {
+            stats.merge(helpers[i].stats);
+            if (helpers[i].stats.depth > stats.depth) {
+                stats.depth = helpers[i].stats.depth;
+                stats.score = helpers[i].stats.score;
+                best_turns = helpers[i].best_line;
+            }
+        }
+        allocations = alloc_count() - allocs_before;
+        stats.time_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        return best_turns;
+    }
+
+    // Прерывание поиска из другого потока (поиск хода бота идёт в фоне, см. Bot_search.h)
+    //
+    // После cancel текущий и все следующие вызовы find_best_turns быстро завершаются,
+    // их результат недостоверен; resume снова разрешает поиск.
+    void cancel()
+    {
+        cancelled->store(true);
+    }
+    void resume()
+    {
+        cancelled->store(false);
+    }
+
+    // Бюджет времени на следующие поиски в миллисекундах (0 — одна итерация сразу на глубину Max_depth),
+    // вместо Bot.MoveTimeMS из настроек
+    void set_move_time(const unsigned int ms)
+    {
+        move_time_ms = ms;
+        for (auto& helper : helpers)
+            helper.move_time_ms = ms;
+    }
+
+    // Лучший ход позиции pos из таблицы транспозиций: клетки начала и конца первого шага хода
+    // (false, если позиции в таблице нет). По нему после поиска восстанавливается продолжение
+    // лучшей линии (FullMoves::principal_variation)
+    bool hash_move(const Position& pos, int& from, int& to) const
+    {
+        tt_entry entry;
+        if (!tt->probe(pos.hash ^ tt_salt, entry) || entry.from == -1)
+            return false;
+        from = entry.from;
+        to = entry.to;
+        return true;
+    }
+
+    // Использовать таблицу транспозиций, эндшпильную базу и дебютную книгу другого объекта
+    // (фоновый поиск на времени соперника наполняет ту же таблицу, что и основной)
+    void share_tables(const Logic& other)
+    {
+        tt = other.tt;
+        tablebase = other.tablebase;
+        book = other.book;
+        helpers.clear(); // помощники создадутся заново уже с новой таблицей
+    }
+
+private:
+    // Конструктор вспомогательного потока поиска: общие таблица транспозиций и флаг остановки,
+    // собственные буферы и генератор случайных чисел (разный порядок ходов у разных потоков)
+    Logic(const Logic& main, const unsigned index) : board(main.board), config(main.config)
+    {
+        seed = main.seed + index;
+        rand_eng = std::default_random_engine(seed);
+        no_random = false; // помощникам случайный порядок равноценных ходов нужен всегда, чтобы не повторять основной поток
+        scoring_mode = main.scoring_mode;
+        optimization = main.optimization;
+        quiescence = main.quiescence;
+        tt_salt = main.tt_salt;
+        move_time_ms = main.move_time_ms;
+        tt = main.tt;
+        tablebase = main.tablebase;
+        abort_search = main.abort_search;
+        cancelled = main.cancelled;
+        threads = 1;
+    }
+
+    // Цикл углубления вспомогательного потока: время не проверяет, останавливается по флагу основного потока
+    void helper_search(const int first_depth) {
+        stats = SearchStats();
+        prepare_search();
+        timed = false;
+        for (search_depth = first_depth; search_depth <= Max_depth; ++search_depth) {
+            auto line = search_root();
+            if (stop)
+                break;
+            best_line = line;
+            stats.depth = search_depth;
+            stats.score = root_score;
+        }
+        // при поиске на фиксированную глубину первый завершивший её поток останавливает остальных
+        if (stats.depth == Max_depth)
+            abort_search->store(true);
+    }
+
+    // Подготовка буферов и флагов потока перед поиском
+    void prepare_search() {
+        stop = false;
+        select_root_search();
+        // ходы-убийцы на каждый уровень рекурсии выделяются один раз на весь поиск:
+        // на каждый полный ход приходится не больше одного уровня плюс по уровню на каждое взятие
+        // (в продлении взятий за горизонтом каждый полный ход начинается со взятия)
+        if (killers.size() < size_t(Max_depth) + 32)
+            killers.resize(size_t(Max_depth) + 32, {move_pos(-1, -1, -1, -1), move_pos(-1, -1, -1, -1)});
+        // история прошлых ходов партии ещё полезна, но должна уступать свежей
+        for (auto& row : history)
+            for (auto& value : row)
+                value /= 2;
+    }
+
+    // Выбор экземпляра поиска по способу подсчёта очков, режиму отсечений и цвету бота
+    //
+    // Настройки и цвет проверяются здесь один раз на поиск, а не в каждом узле: внутри поиска
+    // они — параметры шаблона. Новый способ подсчёта очков добавляется ещё одной ветвью здесь.
+    void select_root_search() {
+        if (scoring_mode == Scoring::NumberAndPotential)
+            select_root_search<Scoring::NumberAndPotential>();
+        else
+            select_root_search<Scoring::NumberOnly>();
+    }
+    template <Scoring S> void select_root_search() {
+        if (optimization == Pruning::O0)
+            select_root_search<S, Pruning::O0>();
+        else
+            select_root_search<S, Pruning::O1>(); // O2 пока совпадает с O1
+    }
+    template <Scoring S, Pruning P> void select_root_search() {
+        root_search = pos.color ? &Logic::find_first_best_turn<S, P, true> : &Logic::find_first_best_turn<S, P, false>;
+    }
+
+    // Поправка ключа таблицы транспозиций на способ оценки позиций
+    //
+    // Одну таблицу могут делить поиски с разными BotScoringType и Quiescence (сессии checkers_engine):
+    // их оценки одной позиции несравнимы, поэтому каждая пара настроек видит в таблице только свои записи.
+    uint64_t evaluation_salt() const
+    {
+        uint64_t salt = 0;
+        if (scoring_mode == Scoring::NumberAndPotential)
+            salt ^= 0x9E3779B97F4A7C15ull;
+        if (!quiescence)
+            salt ^= 0xC2B2AE3D27D4EB4Full;
+        return salt;
+    }
+
+    // Упорядочивание ходов перед перебором: ход из таблицы транспозиций, затем взятия
+    // (взятие дамки раньше взятия шашки; если взятие есть, то взятия — единственные допустимые ходы),
+    // два хода-убийцы этого уровня и остальные по таблице истории.
+    // Случайность остаётся только среди ходов с равным приоритетом и только при NoRandom = false.
+    void order_turns(MoveList& list, const size_t level, const int hash_from, const int hash_to) {
+        if (!no_random)
+            std::shuffle(list.begin(), list.end(), rand_eng);
+        int order_keys[MoveList::capacity];
+        for (size_t i = 0; i < list.size(); ++i) {
+            const move_pos& turn = list[i];
+            const int from = Position::square(turn.x, turn.y), to = Position::square(turn.x2, turn.y2);
+            int order_key;
+            if (from == hash_from && to == hash_to)
+                order_key = 1 << 30;
+            else if (turn.xb != -1)
+                order_key = (1 << 29) + (pos.piece(Position::square(turn.xb, turn.yb)) > 2);
+            else if (turn == killers[level][0])
+                order_key = (1 << 28) + 1;
+            else if (turn == killers[level][1])
+                order_key = 1 << 28;
+            else
+                order_key = history[from][to];
+            order_keys[i] = order_key;
+        }
+        // устойчивая сортировка вставками по убыванию приоритета: списки короткие
+        for (size_t i = 1; i < list.size(); ++i) {
+            const move_pos turn = list[i];
+            const int order_key = order_keys[i];
+            size_t j = i;
+            for (; j > 0 && order_keys[j - 1] < order_key; --j) {
+                list[j] = list[j - 1];
+                order_keys[j] = order_keys[j - 1];
+            }
+            list[j] = turn;
+            order_keys[j] = order_key;
+        }
+    }
+
+    // Запоминает тихий ход, вызвавший отсечение: в ходы-убийцы уровня и в таблицу истории
+    void remember_cutoff(const move_pos& turn, const size_t level, const int remaining) {
+        if (turn.xb != -1)
+            return; // взятия и так просматриваются первыми
+        if (!(turn == killers[level][0])) {
+            killers[level][1] = killers[level][0];
+            killers[level][0] = turn;
+        }
+        int& value = history[Position::square(turn.x, turn.y)][Position::square(turn.x2, turn.y2)];
+        value += remaining * remaining;
+        // история должна оставаться ниже приоритета ходов-убийц (1 << 28) в order_turns:
+        // в долгом поиске таблица ужимается вдвое целиком, соотношения между ходами сохраняются
+        if (value > max_history)
+            for (auto& row : history)
+                for (auto& entry : row)
+                    entry /= 2;
+    }
+
+    // Одна итерация поиска из корня на глубину search_depth
+    //
+    // Начиная со второй итерации корень ищется с узким окном аспирации вокруг оценки прошлой итерации:
+    // узкое окно отсекает больше. Если оценка вышла за окно, оно расширяется в эту сторону,
+    // пока не станет полным.
+    //
+    // Возвращаемый результат:
+    // последовательность лучших ходов (серия взятий целиком)
+    vector<move_pos> search_root() {
+        double delta = aspiration_window;
+        const bool aspiration = (stats.depth >= 0 && optimization != Pruning::O0);
+        double alpha = aspiration ? root_score - delta : -INF;
+        double beta = aspiration ? root_score + delta : INF;
+        while (true) {
+            next_best_state.clear(); // очистка списка состояний переходов
+            next_move.clear();       // очистка последовательности ходов
+            ply = 0;
+
+            // запускаем рекурсию для поиска первого лучшего хода
+            const double score = (this->*root_search)(-1, -1, 0, alpha, beta);
+            if (stop)
+                break;
+            if (score <= alpha && alpha > -INF) {
+                ++stats.aspiration_fails; // оценка ниже окна
+                delta *= 4;
+                alpha = (delta > max_aspiration_window ? -INF : root_score - delta);
+            } else if (score >= beta && beta < INF) {
+                ++stats.aspiration_fails; // оценка выше окна
+                delta *= 4;
+                beta = (delta > max_aspiration_window ? INF : root_score + delta);
+            } else {
+                root_score = score;
+                break;
+            }
+        }
 
         // собираем полный путь наилучших ходов
         int current_state = 0;
@@ -52,58 +443,48 @@ public:
         return result;
     }
 
-private:
-    // Применяет ход на виртуальной матрице доски
-    //
-    // Параметры:
-    // - mtx: текущая матрица доски
-    // - turn: ход для выполнения
-    //
-    // Возвращаемое значение:
-    // новая матрица доски после выполнения хода
-    vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const
-    {
-        if (turn.xb != -1) // Если есть удар, удаляем захваченный элемент
-            mtx[turn.xb][turn.yb] = 0;
-        // Преобразование пешки в дамку при достижении края поля
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) ||
-            (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2;
-        // Перемещение фигуры на новое место
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
-        mtx[turn.x][turn.y] = 0;
-        return mtx;
+    // Проверка остановки: флаги, общие для всех потоков, и бюджет времени
+    // (с часами сверяемся раз в 1024 узла)
+    bool out_of_time() {
+        if (stop)
+            return true;
+        if (abort_search->load(memory_order_relaxed) || cancelled->load(memory_order_relaxed)) {
+            stop = true;
+        } else if (timed && (stats.nodes & 1023) == 0 && chrono::steady_clock::now() >= deadline) {
+            stop = true;
+            abort_search->store(true); // вместе с основным потоком останавливаются помощники
+        }
+        return stop;
     }
 
     // Расчёт текущей оценки позиции
     //
     // Параметры:
-    // - mtx: текущая матрица доски
-    // - first_bot_color: определяет, чей ход считается первым (цвет бота)
+    // Параметры шаблона (известны при компиляции, поэтому в оценке нет ветвлений по настройкам):
+    // - S: способ подсчёта очков
+    // - BotColor: цвет бота
+    //
+    // Параметры:
+    // - pos: текущая позиция
     //
     // Возвращаемое значение:
     // числовая оценка текущей позиции
-    double calc_score(const vector<vector<POS_T>>& mtx, const bool first_bot_color) const
+    template <Scoring S, bool BotColor> static double calc_score(const Position& pos)
     {
-        double white_pawns = 0, white_queens = 0, black_pawns = 0, black_queens = 0;
-        for (POS_T i = 0; i < 8; ++i)
+        double white_queens = pop_count(pos.white & pos.kings); // Белые дамы
+        double black_queens = pop_count(pos.black & pos.kings); // Черные дамы
+        const int white_men = pop_count(pos.white & ~pos.kings);
+        const int black_men = pop_count(pos.black & ~pos.kings);
+        double white_pawns = white_men, black_pawns = black_men; // Белые и черные пешки
+        // Дополнительная стратегия подсчета очков с учётом позиционных факторов:
+        // каждый пройденный шашкой ряд добавляет 0.05 (продвижение ведёт сама позиция)
+        if constexpr (S == Scoring::NumberAndPotential)
         {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                white_pawns += (mtx[i][j] == 1);      // Белые пешки
-                white_queens += (mtx[i][j] == 3);    // Белые дамы
-                black_pawns += (mtx[i][j] == 2);      // Черные пешки
-                black_queens += (mtx[i][j] == 4);    // Черные дамы
-                // Дополнительная стратегия подсчета очков с учётом позиционных факторов
-                if (scoring_mode == "NumberAndPotential")
-                {
-                    white_pawns += 0.05 * (mtx[i][j] == 1) * (7 - i); // Для белых: близость к концу увеличивает ценность
-                    black_pawns += 0.05 * (mtx[i][j] == 2) * (i);     // Для черных аналогично
-                }
-            }
+            white_pawns = (20 * white_men + pos.advance[0]) / 20.0;
+            black_pawns = (20 * black_men + pos.advance[1]) / 20.0;
         }
         // Меняем стороны, если текущая сторона — оппонент бота
-        if (!first_bot_color)
+        if constexpr (!BotColor)
         {
             std::swap(white_pawns, black_pawns);
             std::swap(white_queens, black_queens);
@@ -114,309 +495,658 @@ private:
         if (black_pawns + black_queens == 0)
             return 0;   // Проиграли черные
         // Рассчитываем коэффициент влияния дамок
-        int queen_coefficient = 4;
-        if (scoring_mode == "NumberAndPotential")
-            queen_coefficient = 5;
+        constexpr int queen_coefficient = (S == Scoring::NumberAndPotential) ? 5 : 4;
         // Формула расчёта относительной силы позиций
         return (black_pawns + black_queens * queen_coefficient) /
                (white_pawns + white_queens * queen_coefficient);
     }
 
-    // Главный рекурсивный метод поиска лучшего хода методом минимакса
+    // Ход из дебютной книги для позиции pos
+    //
+    // При NoRandom = false ход выбирается случайно пропорционально весу, иначе берётся самый весомый.
+    // Ход проверяется по правилам: запись, не совпавшая с допустимым ходом, не используется.
+    //
+    // Возвращает false, если позиции нет в книге или запись не годится
+    bool book_move(vector<move_pos>& line) {
+        const auto [first, last] = book->find(pos.hash);
+        uint64_t total = 0;
+        for (const book_entry* entry = first; entry != last; ++entry)
+            total += entry->weight;
+        if (total == 0)
+            return false; // позиции нет в книге или у всех её ходов нулевой вес
+        const book_entry* chosen = first;
+        if (no_random) {
+            for (const book_entry* entry = first; entry != last; ++entry)
+                if (entry->weight > chosen->weight)
+                    chosen = entry;
+        } else {
+            uint64_t pick = uniform_int_distribution<uint64_t>(0, total - 1)(rand_eng);
+            while (pick >= chosen->weight)
+                pick -= (chosen++)->weight;
+        }
+
+        // восстанавливаем шаги хода, сверяя каждый с допустимыми ходами
+        Position p = pos;
+        line.clear();
+        for (int i = 0; i + 1 < chosen->length; ++i) {
+            const int from = chosen->path[i], to = chosen->path[i + 1];
+            const MoveList turns = (i == 0 ? find_turns(p) : find_turns(Position::row(from), Position::col(from), p));
+            if (i > 0 && (line.back().xb == -1 || !turns.beats))
+                return false; // продолжать можно только серию взятий
+            auto turn = std::find_if(turns.begin(), turns.end(), [&](const move_pos& t) {
+                return Position::square(t.x, t.y) == from && Position::square(t.x2, t.y2) == to;
+            });
+            if (turn == turns.end())
+                return false;
+            line.push_back(*turn);
+            move_undo undo;
+            p.do_move(*turn, undo);
+        }
+        // серия взятий должна быть доведена до конца
+        if (line.empty() || line.back().xb != -1 && find_turns(line.back().x2, line.back().y2, p).beats)
+            return false;
+        return true;
+    }
+
+    // Перевод значения эндшпильной базы в оценку со стороны бота
+    //
+    // Выигрыш оценивается чуть ниже INF, тем ниже, чем он дальше; проигрыш — чуть выше 0,
+    // тем выше, чем он дальше (ниже любого соотношения материала); ничья — как равный материал.
+    //
+    // Параметры:
+    // - value: значение tb_value для стороны, которой ходить
+    // - depth: глубина узла
+    // - bot_to_move: ходит бот
+    static double tablebase_score(const uint8_t value, const size_t depth, const bool bot_to_move)
+    {
+        if (value == tb_value::DRAW)
+            return 1;
+        const bool mover_wins = value < tb_value::LOSS;
+        const int plies = int(depth) + 1 + (mover_wins ? value : value - tb_value::LOSS);
+        if (mover_wins == bot_to_move)
+            return INF - plies;
+        return plies * 1e-4;
+    }
+
+    // Перевод оценки со стороны бота (отношение сил: 0 — проигрыш бота, INF — выигрыш) в оценку негамакса
+    //
+    // Негамакс считает оценку со стороны ходящего, и смена стороны должна быть сменой знака,
+    // поэтому берётся логарифм отношения сил: ответ соперника (обратное отношение) — это минус оценка.
+    // Порядок оценок сохраняется; выигрыш — log(INF), проигрыш — -log(INF).
+    //
+    // Параметры:
+    // - ratio: оценка со стороны бота (calc_score, tablebase_score)
+    // - bot_to_move: ходит бот
+    static double to_value(const double ratio, const bool bot_to_move)
+    {
+        const double value = std::log(std::max(ratio, 1.0 / INF));
+        return bot_to_move ? value : -value;
+    }
+
+    // Статическая оценка позиции pos со стороны ходящего
+    template <Scoring S, bool BotColor, bool BotMoves> double evaluate() const
+    {
+        return to_value(calc_score<S, BotColor>(pos), BotMoves);
+    }
+
+    // Поиск из корня с перебором серии взятий бота (ходы серии запоминаются для линии лучших ходов)
+    //
+    // Работает на общей позиции pos: ходы выполняются на месте и отменяются после возврата.
+    // Первый ход просматривается с полным окном, остальные — с нулевым окном (alpha, alpha + ε):
+    // так дешевле убедиться, что ход не лучше уже найденного; если он всё же лучше, он
+    // пересчитывается с полным окном (principal variation search).
+    //
+    // Параметры шаблона: S — способ подсчёта очков, P — отсечения, BotColor — цвет бота
+    // (выбираются один раз на поиск, см. select_root_search).
     //
     // Параметры:
-    // - mtx: текущая конфигурация доски
-    // - color: цвет текущего игрока
-    // - x, y: начальные координаты хода
+    // - x, y: клетка бьющей фигуры посреди серии взятий (-1 в корне)
     // - state: номер текущего состояния
-    // - alpha, beta: значения для альфа-бета-отсечения
+    // - alpha, beta: окно поиска со стороны бота
     //
     // Возвращает:
-    // численную оценку текущего состояния
+    // оценку со стороны бота (см. to_value)
+    template <Scoring S, Pruning P, bool BotColor>
     double find_first_best_turn(
-        vector<vector<POS_T>> mtx, 
-        const bool color, 
         const POS_T x, 
         const POS_T y, 
         size_t state, 
-        double alpha = -INF
+        double alpha,
+        const double beta
     ) {
+        ++stats.nodes;
         next_best_state.push_back(-1); // добавляем новое состояние в список
         next_move.emplace_back(-1, -1, -1, -1); // инициализируем новый ход пустым значением
 
         double best_score = -INF; // лучшая оценка пока неизвестна
-        if (state != 0) {
-            find_turns(x, y, mtx); // получаем возможные ходы из текущей позиции
-        }
-        auto available_turns = turns;
-        bool has_beats = have_beats; // проверяем наличие обязательных захватов
+        // ходы уровня хранятся в его кадре; в корне — ходы, упорядоченные прошлыми итерациями
+        const MoveList available_turns =
+            (state != 0 ? generate<BotColor>(Position::square(x, y), pos) : root_turns);
+        const bool has_beats = available_turns.beats; // проверяем наличие обязательных захватов
 
         // если игрок завершил серию взятий, передаем ход противнику
         if (!has_beats && state != 0) {
-            return find_best_turns_rec(mtx, !color, 0, alpha);
+            pos.pass_turn();
+            const double score = -find_best_turns_rec<S, P, BotColor, false>(0, -beta, -alpha);
+            pos.pass_turn();
+            return score;
         }
 
+        ++ply;
+
         // выполняем поиск лучшего хода
-        vector<move_pos> best_moves;
-        vector<int> best_states;
-        for (auto turn : available_turns) {
+        for (const auto& turn : available_turns) {
             size_t next_state = next_move.size(); // индекс следующего возможного состояния
+            move_undo undo;
+            pos.do_move(turn, undo);
+            // оценка хода с окном (a, b)
+            auto search_turn = [&](const double a, const double b) {
+                if (has_beats) {
+                    // серия захватов продолжается, рекурсивно продолжаем искать лучшие удары
+                    next_state = next_move.size();
+                    return find_first_best_turn<S, P, BotColor>(turn.x2, turn.y2, next_state, a, b);
+                }
+                // обычный ход без захвата
+                pos.pass_turn();
+                const double score = -find_best_turns_rec<S, P, BotColor, false>(0, -b, -a);
+                pos.pass_turn();
+                return score;
+            };
             double score;
-            if (has_beats) {
-                // серия захватов продолжается, рекурсивно продолжаем искать лучшие удары
-                score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, next_state, best_score);
+            if (best_score == -INF || P == Pruning::O0) {
+                score = search_turn(alpha, beta);
             } else {
-                // обычный ход без захвата
-                score = find_best_turns_rec(make_turn(mtx, turn), !color, 0, best_score);
+                score = search_turn(alpha, std::nextafter(alpha, double(INF)));
+                if (score > alpha && score < beta && !stop) {
+                    ++stats.researches;
+                    score = search_turn(alpha, beta);
+                }
             }
+            pos.undo_move(turn, undo);
+            if (stop)
+                break; // время вышло, оценка недостоверна
             if (score > best_score) {
                 best_score = score;
                 next_best_state[state] = (has_beats ? static_cast<int>(next_state) : -1); // запоминаем следующий лучший ход
                 next_move[state] = turn; // записываем лучший ход
             }
+            alpha = std::max(alpha, best_score);
+            if (P != Pruning::O0 && alpha >= beta)
+                break; // оценка вышла за окно аспирации, корень будет пересчитан
         }
+        --ply;
         return best_score;
     }
 
-    // Вспомогательная рекурсивная функция поиска наилучших ходов методом минимакса
+    // Рекурсивный поиск методом негамакс с нулевыми окнами (principal variation search)
+    //
+    // Работает на общей позиции pos (цвет текущего игрока хранится в pos.color).
+    // Оценка считается со стороны ходящего: ответ соперника оценивается как минус его оценка
+    // с окном (-beta, -alpha). Первый ход узла просматривается с полным окном, остальные — с нулевым,
+    // и только ход, оказавшийся лучше alpha, пересчитывается с полным окном.
+    //
+    // Параметры шаблона: S, P, BotColor — как у find_first_best_turn; BotMoves — ходит бот
+    // (на нечётной глубине). Ходящий известен при компиляции, поэтому генератор ходов вызывается
+    // сразу для его цвета.
     //
     // Параметры:
-    // - mtx: текущая конфигурация доски
-    // - color: цвет текущего игрока
     // - depth: текущая глубина рекурсии
-    // - alpha, beta: пределы для отсечения вариантов
-    // - x, y: координаты текущей клетки (опционально)
+    // - alpha, beta: окно поиска со стороны ходящего
+    // - x, y: координаты бьющей фигуры посреди серии взятий (опционально)
     //
     // Возвращает:
-    // числовую оценку позиции
+    // оценку позиции со стороны ходящего (см. to_value)
+    template <Scoring S, Pruning P, bool BotColor, bool BotMoves>
     double find_best_turns_rec(
-        vector<vector<POS_T>> mtx, 
-        const bool color, 
         const size_t depth, 
-        double alpha = -INF, 
-        double beta = INF + 1, 
+        double alpha, 
+        const double beta,
         const POS_T x = -1, 
         const POS_T y = -1
     ) {
-        if (depth == Max_depth) {
-            return calc_score(mtx, ((depth % 2) == color)); // считаем оценку позиции
+        ++stats.nodes;
+        if (out_of_time()) {
+            return 0; // результат прерванной итерации отбрасывается
+        }
+        // позиция из эндшпильной базы: точное значение вместо поиска и оценки
+        uint8_t tablebase_value;
+        if (x == -1 && tablebase && tablebase->probe(pos, tablebase_value)) {
+            ++stats.tablebase_hits;
+            return to_value(tablebase_score(tablebase_value, depth, BotMoves), BotMoves);
+        }
+        if (depth == size_t(search_depth)) {
+            if (quiescence)
+                return quiesce<S, P, BotColor, BotMoves>(depth, alpha, beta); // на горизонте доигрываем взятия
+            return evaluate<S, BotColor, BotMoves>(); // считаем оценку позиции
         }
 
-        if (x != -1) {
-            find_turns(x, y, mtx); // находим доступные ходы из конкретной позиции
-        } else {
-            find_turns(color, mtx); // иначе ищем любые возможные ходы
+        // в начале полного хода проверяем таблицу транспозиций (посреди серии взятий ключ не учитывает бьющую фигуру);
+        // оценки со стороны ходящего не зависят от цвета бота, поэтому ключ — хеш позиции
+        // с поправкой на способ оценки (см. evaluation_salt)
+        const uint64_t key = pos.hash ^ tt_salt;
+        const int remaining = search_depth - int(depth);
+        int hash_from = -1, hash_to = -1;
+        if (x == -1) {
+            tt_entry entry;
+            ++stats.tt_probes;
+            if (tt->probe(key, entry)) {
+                ++stats.tt_hits;
+                if (entry.depth >= remaining &&
+                    (entry.bound == Bound::EXACT ||
+                     (entry.bound == Bound::LOWER && entry.score >= beta) ||
+                     (entry.bound == Bound::UPPER && entry.score <= alpha))) {
+                    ++stats.tt_cutoffs;
+                    return entry.score; // сохранённой оценки достаточно
+                }
+                hash_from = entry.from; // лучший ход из таблицы просматриваем первым
+                hash_to = entry.to;
+            }
         }
-        auto available_turns = turns;
-        bool has_beats = have_beats;
+
+        // ходы из конкретной клетки посреди серии взятий, иначе любые возможные ходы;
+        // список хранится в кадре рекурсии этого уровня
+        constexpr bool Color = (BotMoves ? BotColor : !BotColor); // цвет ходящего
+        MoveList available_turns = (x != -1 ? generate<Color>(Position::square(x, y), pos) : generate<Color>(pos));
+        const bool has_beats = available_turns.beats;
 
         // если мы завершили возможность удара, передаем ход другому игроку
         if (!has_beats && x != -1) {
-            return find_best_turns_rec(mtx, !color, depth + 1, alpha, beta);
+            pos.pass_turn();
+            const double score = -find_best_turns_rec<S, P, BotColor, !BotMoves>(depth + 1, -beta, -alpha);
+            pos.pass_turn();
+            return score;
         }
 
         if (available_turns.empty()) {
-            return (depth % 2 ? 0 : INF); // проверка на отсутствие доступных ходов
+            return to_value(0, true); // ходить нечем — проигрыш ходящего
         }
 
-        double min_score = INF + 1;
-        double max_score = -INF;
-        for (auto turn : available_turns) {
-            double score = 0.0;
-            if (!has_beats && x == -1) {
-                // простой стандартно-доступный ход
-                score = find_best_turns_rec(make_turn(mtx, turn), !color, depth + 1, alpha, beta);
+        // упорядочиваем ходы своего уровня
+        const size_t level = ply++;
+        stats.seldepth = max(stats.seldepth, int(ply));
+        order_turns(available_turns, level, hash_from, hash_to);
+
+        const double alpha_orig = alpha;
+        double best_score = -INF;
+        const move_pos* best_turn = nullptr;
+        for (const auto& turn : available_turns) {
+            move_undo undo;
+            pos.do_move(turn, undo);
+            // оценка хода с окном (a, b) со стороны ходящего в этом узле
+            auto search_turn = [&](const double a, const double b) {
+                if (!has_beats && x == -1) {
+                    // простой стандартно-доступный ход, отвечает соперник
+                    pos.pass_turn();
+                    const double score = -find_best_turns_rec<S, P, BotColor, !BotMoves>(depth + 1, -b, -a);
+                    pos.pass_turn();
+                    return score;
+                }
+                // возможна цепочка захватывающих ходов того же игрока
+                return find_best_turns_rec<S, P, BotColor, BotMoves>(depth, a, b, turn.x2, turn.y2);
+            };
+            double score;
+            if (!best_turn || P == Pruning::O0) {
+                score = search_turn(alpha, beta);
             } else {
-                // возможна цепочка захватывающих ходов
-                score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
+                score = search_turn(alpha, std::nextafter(alpha, double(INF)));
+                if (score > alpha && score < beta && !stop) {
+                    ++stats.researches; // ход оказался лучше найденного: уточняем оценку
+                    score = search_turn(alpha, beta);
+                }
             }
-            min_score = std::min(min_score, score); // минимальная оценка
-            max_score = std::max(max_score, score); // максимальная оценка
-            
-            // альфа-бета отсечение
-            if (depth % 2) {
-                alpha = std::max(alpha, max_score);
-            } else {
-                beta = std::min(beta, min_score);
+            pos.undo_move(turn, undo);
+            if (stop) {
+                break;
             }
-            if (optimization != "O0" && alpha >= beta) {
-                return (depth % 2 ? max_score + 1 : min_score - 1); // сокращение поиска при достижении пределов
+            if (score > best_score) {
+                best_score = score;
+                best_turn = &turn; // ход, давший лучшую оценку для текущего игрока
+            }
+
+            // альфа-бета отсечение
+            alpha = std::max(alpha, best_score);
+            if (P != Pruning::O0 && alpha >= beta) {
+                stats.add_cutoff(size_t(&turn - available_turns.begin()));
+                remember_cutoff(turn, level, remaining);
+                break; // сокращение поиска при достижении пределов
             }
         }
-        return (depth % 2 ? max_score : min_score); // возвращаем лучшую оценку
+        --ply;
+        if (stop) {
+            return 0; // незавершённый узел не сохраняем
+        }
+
+        // после отсечения оценка — граница, а не точное значение
+        if (x == -1) {
+            const Bound bound =
+                (best_score <= alpha_orig ? Bound::UPPER : (best_score >= beta ? Bound::LOWER : Bound::EXACT));
+            tt->store(key, best_score, bound, remaining, Position::square(best_turn->x, best_turn->y),
+                     Position::square(best_turn->x2, best_turn->y2));
+        }
+        return best_score;
     }
 
+    // Форсированное продление взятий за горизонтом поиска
+    //
+    // Пока у ходящего есть обязательные взятия, позиция не оценивается статически: перебираются только
+    // взятия (серии целиком), и оценка берётся после размена. Тихая позиция оценивается calc_score.
+    // Отсечение по оценке «без хода» (stand pat): ходящий только приобретает материал взятием, поэтому
+    // если статическая оценка уже не ниже beta, узел отсекается без перебора взятий.
+    // Бить обязательно, поэтому статическая оценка alpha не поднимает: ниже beta узел перебирается полностью.
+    // Глубина ограничена числом фигур: каждое взятие убирает одну из них.
+    //
+    // Параметры шаблона — как у find_best_turns_rec.
+    //
+    // Параметры:
+    // - depth: глубина узла (продолжает нумерацию основного поиска)
+    // - alpha, beta: окно поиска со стороны ходящего
+    // - x, y: клетка бьющей фигуры посреди серии взятий (-1 — начало хода)
+    //
+    // Возвращает:
+    // оценку позиции со стороны ходящего
+    template <Scoring S, Pruning P, bool BotColor, bool BotMoves>
+    double quiesce(const size_t depth, double alpha, const double beta, const POS_T x = -1, const POS_T y = -1) {
+        ++stats.nodes;
+        ++stats.qnodes;
+        if (out_of_time()) {
+            return 0; // результат прерванной итерации отбрасывается
+        }
+        uint8_t tablebase_value;
+        if (x == -1 && tablebase && tablebase->probe(pos, tablebase_value)) {
+            ++stats.tablebase_hits;
+            return to_value(tablebase_score(tablebase_value, depth, BotMoves), BotMoves);
+        }
+
+        // при x != -1 — продолжение серии той же фигурой
+        constexpr bool Color = (BotMoves ? BotColor : !BotColor);
+        MoveList available_turns = (x != -1 ? generate<Color>(Position::square(x, y), pos) : generate<Color>(pos));
+        const bool has_beats = available_turns.beats;
+        if (x != -1 && !has_beats) {
+            // серия закончилась, отвечает соперник
+            pos.pass_turn();
+            const double score = -quiesce<S, P, BotColor, !BotMoves>(depth + 1, -beta, -alpha);
+            pos.pass_turn();
+            return score;
+        }
+        if (available_turns.empty()) {
+            return to_value(0, true); // ходить нечем — проигрыш ходящего
+        }
+        if (!has_beats) {
+            return evaluate<S, BotColor, BotMoves>(); // позиция спокойна
+        }
+        if (P != Pruning::O0 && x == -1) {
+            const double stand_pat = evaluate<S, BotColor, BotMoves>();
+            if (stand_pat >= beta) {
+                return stand_pat;
+            }
+        }
+
+        const size_t level = ply++;
+        stats.seldepth = max(stats.seldepth, int(ply));
+        order_turns(available_turns, level, -1, -1);
+
+        double best_score = -INF;
+        for (const auto& turn : available_turns) {
+            move_undo undo;
+            pos.do_move(turn, undo);
+            const double score = quiesce<S, P, BotColor, BotMoves>(depth, alpha, beta, turn.x2, turn.y2);
+            pos.undo_move(turn, undo);
+            if (stop) {
+                break;
+            }
+            best_score = std::max(best_score, score);
+            alpha = std::max(alpha, best_score);
+            if (P != Pruning::O0 && alpha >= beta) {
+                break;
+            }
+        }
+        --ply;
+        return best_score;
+    }
 
 
 public:
-    // Находит доступные ходы для определенного цвета
+    // Находит доступные ходы для определенного цвета на текущей доске
     //
     // Параметры:
     // - color: цвет игрока
-    void find_turns(const bool color)
+    MoveList find_turns(const bool color) const
     {
-        find_turns(color, board->get_board()); // Просто передаем текущую доску
+        return find_turns(Position(board->get_board(), color)); // Переводим текущую доску в позицию
     }
 
-    // Находит доступные ходы из конкретной клетки
+    // Находит доступные ходы из конкретной клетки текущей доски
     //
     // Параметры:
     // - x, y: координаты клетки
-    void find_turns(const POS_T x, const POS_T y)
+    MoveList find_turns(const POS_T x, const POS_T y) const
     {
-        find_turns(x, y, board->get_board()); // Так же передаем текущую доску
+        return find_turns(x, y, Position(board->get_board())); // Так же переводим текущую доску
     }
 
-private:
-    // Основной метод для поиска доступных ходов
+    // Основной метод для поиска доступных ходов (используется и поиском, и инструментами)
+    //
+    // Генератор не меняет состояния объекта, поэтому его можно вызывать из любого потока:
+    // каждый уровень поиска хранит свой список ходов у себя на стеке.
     //
     // Параметры:
-    // - color: цвет игрока
-    // - mtx: текущая матрица доски
-    void find_turns(const bool color, const vector<vector<POS_T>>& mtx)
+    // - pos: текущая позиция, ходы ищутся для игрока pos.color
+    //
+    // Возвращает:
+    // взятия всех фигур (beats = true), а если их нет — обычные ходы
+    static MoveList find_turns(const Position& pos)
     {
-        vector<move_pos> result_turns;
-        bool found_beats = false;
-        for (POS_T i = 0; i < 8; ++i)
-        {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                if (mtx[i][j] && mtx[i][j] % 2 != color)
-                {
-                    find_turns(i, j, mtx); // Находим возможные ходы из клетки (i,j)
-                    if (have_beats && !found_beats)
-                    {
-                        found_beats = true;
-                        result_turns.clear(); // Чистим предыдущие результаты, если нашли атаку
-                    }
-                    if ((found_beats && have_beats) || !found_beats)
-                    {
-                        result_turns.insert(result_turns.end(), turns.begin(), turns.end());
-                    }
-                }
-            }
-        }
-        turns = result_turns; // Результаты помещаются в общий массив ходов
-        std::shuffle(turns.begin(), turns.end(), rand_eng); // Случайная перестановка ходов
-        have_beats = found_beats;
+        return pos.color ? generate<true>(pos) : generate<false>(pos); // Цвет выбирается один раз на позицию
     }
 
-    // Находит возможные ходы из определенной клетки
+    // Находит возможные ходы из определенной клетки (продолжение серии взятий)
     //
     // Параметры:
     // - x, y: координаты клетки
-    // - mtx: текущая матрица доски
-    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx)
+    // - pos: текущая позиция
+    //
+    // Возвращает:
+    // взятия фигуры (beats = true), а если их нет — её обычные ходы
+    static MoveList find_turns(const POS_T x, const POS_T y, const Position& pos)
     {
-        turns.clear(); // Очищаем ранее сохранённые ходы
-        have_beats = false; // Пока нет никаких ударов
-        POS_T piece_type = mtx[x][y]; // Тип фигуры на текущей клетке
+        const int sq = Position::square(x, y);
+        return (pos.black & (1u << sq)) ? generate<true>(sq, pos) : generate<false>(sq, pos);
+    }
 
-        // Различные случаи проверок хода
-        switch (piece_type)
+private:
+    // Ходы игрока Color (0 — белые, 1 — чёрные): цвет известен при компиляции,
+    // поэтому в циклах по фигурам нет проверок, чья фигура и куда ходят её шашки
+    template <bool Color> static MoveList generate(const Position& pos)
+    {
+        MoveList result;
+        // Перебираем только клетки с фигурами текущего игрока
+        const uint32_t own = Color ? pos.black : pos.white;
+        for (uint32_t mask = own; mask; mask &= mask - 1)
+            add_beats<Color>(lsb_index(mask), pos, result);
+        if (!result.empty())
         {
-        case 1: // Белая простая фигура
-        case 2: // Черная простая фигура
-            // Проверка простых ходов (без взятий)
-            for (POS_T i = x - 2; i <= x + 2; i += 4)
-            {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7)
-                        continue;
-                    POS_T middle_x = (x + i) / 2, middle_y = (y + j) / 2;
-                    if (mtx[i][j] || !mtx[middle_x][middle_y] || mtx[middle_x][middle_y] % 2 == piece_type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, middle_x, middle_y); // Добавляем ход с ударом
-                }
-            }
-            break;
-        default: // Дамка
-            // Проверка вертикальных и горизонтальных ходов дамки
-            for (POS_T dir_i = -1; dir_i <= 1; dir_i += 2)
-            {
-                for (POS_T dir_j = -1; dir_j <= 1; dir_j += 2)
-                {
-                    POS_T last_blocked_x = -1, last_blocked_y = -1;
-                    for (POS_T i2 = x + dir_i, j2 = y + dir_j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += dir_i, j2 += dir_j)
-                    {
-                        if (mtx[i2][j2]) // Если встречена фигура
-                        {
-                            if (mtx[i2][j2] % 2 == piece_type % 2 || (last_blocked_x != -1 && last_blocked_x != i2))
-                            {
-                                break; // Невозможен дальнейший ход
-                            }
-                            last_blocked_x = i2;
-                            last_blocked_y = j2;
-                        }
-                        if (last_blocked_x != -1 && last_blocked_x != i2)
-                        {
-                            turns.emplace_back(x, y, i2, j2, last_blocked_x, last_blocked_y); // Добавляем удар
-                        }
-                    }
-                }
-            }
-            break;
+            result.beats = true; // Если есть взятие, другие ходы недопустимы
+            return result;
         }
-        // Если были найдены удары, добавляем обычные ходы
-        if (!turns.empty())
+        for (uint32_t mask = own; mask; mask &= mask - 1)
+            add_moves<Color>(lsb_index(mask), pos, result);
+        return result;
+    }
+
+    // Ходы фигуры игрока Color с клетки sq
+    template <bool Color> static MoveList generate(const int sq, const Position& pos)
+    {
+        MoveList result;
+        add_beats<Color>(sq, pos, result);
+        if (!result.empty())
         {
-            have_beats = true;
-            return;
+            result.beats = true;
+            return result;
         }
-        // Проверка обычных ходов для простой фигуры или дамки
-        switch (piece_type)
+        add_moves<Color>(sq, pos, result);
+        return result;
+    }
+
+    // Добавляет в список взятия фигуры игрока Color с клетки sq
+    //
+    // Геометрия ходов берётся из таблиц move_table, вычисленных при компиляции:
+    // для шашки это пары клеток «через кого прыгаем — куда встаём», для дамки — лучи,
+    // на которых ближайшая фигура находится одной битовой операцией.
+    template <bool Color> static void add_beats(const int sq, const Position& pos, MoveList& list)
+    {
+        const POS_T x = Position::row(sq), y = Position::col(sq);
+        const uint32_t occupied = pos.white | pos.black;
+        const uint32_t enemy = Color ? pos.white : pos.black;
+
+        if (!(pos.kings & (1u << sq)))
         {
-        case 1: // Белая простая фигура
-        case 2: // Черная простая фигура
+            // Шашка бьёт во все четыре стороны: рядом фигура соперника, за ней пустая клетка
+            for (int dir = 0; dir < 4; ++dir)
             {
-                POS_T dx = ((piece_type % 2) ? x - 1 : x + 1); // Направление хода вперед
-                for (POS_T dy = y - 1; dy <= y + 1; dy += 2)
-                {
-                    if (dx < 0 || dx > 7 || dy < 0 || dy > 7 || mtx[dx][dy])
-                        continue;
-                    turns.emplace_back(x, y, dx, dy); // Добавляем обычный ход
-                }
-                break;
+                const int over = move_table.jump_over[sq][dir], land = move_table.jump_land[sq][dir];
+                if (over == -1 || !(enemy & (1u << over)) || (occupied & (1u << land)))
+                    continue;
+                list.emplace_back(x, y, Position::row(land), Position::col(land), Position::row(over),
+                                  Position::col(over)); // Добавляем ход с ударом
             }
-        default: // Дамка
-            for (POS_T di = -1; di <= 1; di += 2)
+            return;
+        }
+        // Дамка: на каждом луче бить можно только ближайшую фигуру, если она чужая
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const uint32_t blockers = move_table.ray[sq][dir] & occupied;
+            if (!blockers)
+                continue;
+            const int captured = nearest_square(blockers, dir);
+            if (!(enemy & (1u << captured)))
+                continue;
+            add_ray_turns(x, y, free_ray(captured, dir, occupied), dir, captured, list); // Добавляем удары
+        }
+    }
+
+    // Добавляет в список обычные ходы фигуры игрока Color с клетки sq
+    template <bool Color> static void add_moves(const int sq, const Position& pos, MoveList& list)
+    {
+        const POS_T x = Position::row(sq), y = Position::col(sq);
+        const uint32_t occupied = pos.white | pos.black;
+
+        if (!(pos.kings & (1u << sq)))
+        {
+            // Белые шашки ходят вверх (направления 0 и 1), чёрные вниз (2 и 3)
+            for (int dir = Color ? 2 : 0; dir <= (Color ? 3 : 1); ++dir)
             {
-                for (POS_T dj = -1; dj <= 1; dj += 2)
-                {
-                    for (POS_T i2 = x + di, j2 = y + dj; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += di, j2 += dj)
-                    {
-                        if (mtx[i2][j2])
-                            break; // Нельзя пройти дальше фигуры
-                        turns.emplace_back(x, y, i2, j2); // Добавляем обычный ход
-                    }
-                }
+                const int to = move_table.neighbour[sq][dir];
+                if (to == -1 || (occupied & (1u << to)))
+                    continue;
+                list.emplace_back(x, y, Position::row(to), Position::col(to)); // Добавляем обычный ход
             }
-            break;
+            return;
+        }
+        for (int dir = 0; dir < 4; ++dir)
+            add_ray_turns(x, y, free_ray(sq, dir, occupied), dir, -1, list); // Пустые клетки луча до первой фигуры
+    }
+
+    // Ближайшая к началу луча клетка из маски (лучи 0 и 1 идут к меньшим номерам клеток)
+    static int nearest_square(const uint32_t mask, const int dir)
+    {
+        return dir < 2 ? msb_index(mask) : lsb_index(mask);
+    }
+
+    // Пустые клетки луча из клетки sq по направлению dir до первой фигуры
+    static uint32_t free_ray(const int sq, const int dir, const uint32_t occupied)
+    {
+        const uint32_t ray = move_table.ray[sq][dir];
+        const uint32_t blockers = ray & occupied;
+        if (!blockers)
+            return ray;
+        const int blocker = nearest_square(blockers, dir);
+        return ray & ~(move_table.ray[blocker][dir] | (1u << blocker));
+    }
+
+    // Добавляет ходы дамки на клетки маски в порядке удаления от неё (captured = -1 для ходов без удара)
+    static void add_ray_turns(const POS_T x, const POS_T y, uint32_t targets, const int dir, const int captured,
+                              MoveList& list)
+    {
+        while (targets)
+        {
+            const int to = nearest_square(targets, dir);
+            targets &= ~(1u << to);
+            if (captured == -1)
+                list.emplace_back(x, y, Position::row(to), Position::col(to));
+            else
+                list.emplace_back(x, y, Position::row(to), Position::col(to), Position::row(captured),
+                                  Position::col(captured));
         }
     }
 
 public:
-    // Массив доступных ходов
-    vector<move_pos> turns;
-    // Наличие обязательных ударов
-    bool have_beats;
     // Максимальная глубина поиска
     int Max_depth;
+    // Число выделений динамической памяти за последний поиск (считается при сборке с CHECKERS_COUNT_ALLOCS)
+    size_t allocations = 0;
+    // Счётчики последнего поиска: узлы, таблица транспозиций, отсечения, глубина, время
+    SearchStats stats;
 
 private:
-    // Генератор случайных чисел
+    // Генератор случайных чисел и его начальное значение
     std::default_random_engine rand_eng;
+    unsigned seed = 0;
+    // Детерминированный режим (без случайного выбора среди равноценных ходов)
+    bool no_random = false;
     // Способ подсчета очков
-    string scoring_mode;
+    Scoring scoring_mode = Scoring::NumberOnly;
     // Тип оптимизации (alpha-beta cutoff)
-    string optimization;
+    Pruning optimization = Pruning::O1;
+    // Экземпляр поиска из корня для текущих настроек и цвета бота (select_root_search)
+    double (Logic::*root_search)(POS_T, POS_T, size_t, double, double) = nullptr;
+    // Доигрывать взятия на горизонте поиска (Quiescence)
+    bool quiescence = true;
+    // Позиция, на которой выполняется поиск (ходы делаются и отменяются на месте)
+    Position pos;
+    // Бюджет времени на ход в миллисекундах (0 — без ограничения)
+    unsigned int move_time_ms = 0;
+    // Момент, когда поиск должен остановиться
+    chrono::steady_clock::time_point deadline;
+    // Проверять ли время в текущей итерации
+    bool timed = false;
+    // Флаг прерывания поиска в этом потоке
+    bool stop = false;
+    // Флаг остановки, общий для основного и вспомогательных потоков
+    shared_ptr<atomic<bool>> abort_search;
+    // Флаг прерывания поиска извне (cancel), тоже общий для всех потоков
+    shared_ptr<atomic<bool>> cancelled;
+    // Число потоков поиска
+    unsigned threads = 1;
+    // Вспомогательные потоки поиска (Lazy SMP)
+    vector<Logic> helpers;
+    // Последняя завершённая линия вспомогательного потока
+    vector<move_pos> best_line;
+    // Глубина текущей итерации
+    int search_depth = 0;
+    // Ходы из корня (порядок уточняется от итерации к итерации)
+    MoveList root_turns;
+    // Таблица транспозиций, общая для всех потоков
+    shared_ptr<TranspositionTable> tt;
+    // Поправка ключа таблицы на способ оценки (evaluation_salt)
+    uint64_t tt_salt = 0;
+    // Эндшпильная база, общая для всех потоков (nullptr — база не подключена)
+    shared_ptr<Tablebase> tablebase;
+    // Дебютная книга (nullptr — книга не подключена)
+    shared_ptr<OpeningBook> book;
+    // Оценка последней завершённой итерации (центр окна аспирации следующей)
+    double root_score = 0;
+    // Текущий уровень рекурсии (индекс в killers)
+    size_t ply = 0;
+    // Ходы-убийцы: по два тихих хода на уровень, вызвавших отсечение
+    vector<array<move_pos, 2>> killers;
+    // Таблица истории отсечений по клеткам начала и конца хода
+    int history[32][32] = {};
     // Последовательность состояний
     vector<move_pos> next_move;
     // Следующее лучшее состояние
     vector<int> next_best_state;
     // Указатель на доску
-    Board* board;
+    BoardState* board;
     // Указатель на конфигурацию
     Config* config;
 };
@@ -0,0 +1,85 @@
+#pragma once
+#include <random>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Board_state.h"
+#include "Logic.h"
+
+// Партия бот против бота без окна и задержек: тот же цикл, что и в Game::play, но без отрисовки
+class Match
+{
+public:
+    // Параметры:
+    // - board: доска без отрисовки, к которой привязаны оба бота
+    // - white, black: боты, играющие белыми и чёрными
+    // - white_level, black_level: глубина расчёта каждого бота
+    // - max_turns: число ходов до ничьей
+    Match(BoardState* board, Logic* white, Logic* black, const int white_level, const int black_level, const int max_turns)
+        : board(board), white(white), black(black), white_level(white_level), black_level(black_level), max_turns(max_turns)
+    {}
+
+    // Делает plies случайных ходов из текущей позиции (серия взятий считается одним ходом)
+    //
+    // Возвращает номер следующего хода или -1, если у одной из сторон кончились ходы
+    int random_opening(const int plies, std::mt19937& rng)
+    {
+        for (int turn_num = 0; turn_num < plies; ++turn_num)
+        {
+            Logic& logic = (turn_num % 2) ? *black : *white;
+            MoveList turns = logic.find_turns(turn_num % 2);
+            if (turns.empty())
+                return -1;
+            move_pos turn = turns[rng() % turns.size()];
+            int beat_series = 0;
+            moves.emplace_back();
+            while (true)
+            {
+                beat_series += (turn.xb != -1);
+                board->move_piece(turn, beat_series);
+                moves.back().push_back(turn);
+                if (turn.xb == -1)
+                    break;
+                turns = logic.find_turns(turn.x2, turn.y2); // Серия взятий продолжается
+                if (!turns.beats)
+                    break;
+                turn = turns[rng() % turns.size()];
+            }
+        }
+        return plies;
+    }
+
+    // Играет партию с хода turn_num
+    //
+    // Возвращает результат в кодах Board::show_final: 0 — ничья, 1 — победа белых, 2 — победа чёрных
+    int play(int turn_num = 0)
+    {
+        for (; turn_num < max_turns; ++turn_num)
+        {
+            const bool color = turn_num % 2;
+            Logic& logic = color ? *black : *white;
+            if (logic.find_turns(color).empty()) // Игрок без ходов проиграл
+                return color ? 1 : 2;
+            logic.Max_depth = color ? black_level : white_level;
+            int beat_series = 0;
+            moves.push_back(logic.find_best_turns(color));
+            for (auto turn : moves.back())
+            {
+                beat_series += (turn.xb != -1);
+                board->move_piece(turn, beat_series);
+            }
+        }
+        return 0;
+    }
+
+    // Сыгранные ходы (шаги каждого полного хода), включая случайный дебют
+    vector<vector<move_pos>> moves;
+
+private:
+    BoardState* board;
+    Logic* white;
+    Logic* black;
+    int white_level;
+    int black_level;
+    int max_turns;
+};
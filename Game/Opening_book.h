@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Запись дебютной книги: ход из позиции с ключом key и его вес.
+// Ход хранится номерами клеток Position: начальная клетка и клетки остановки каждого шага
+// (для тихого хода — две клетки, для серии взятий — по клетке на каждое взятие).
+struct book_entry
+{
+    uint64_t key = 0;    // Ключ Zobrist позиции (с очередью хода)
+    uint32_t weight = 0; // Вес хода: чем больше, тем чаще он выбирается
+    uint8_t length = 0;  // Число клеток в path
+    int8_t path[11] = {}; // Клетки хода (до 10 взятий в серии)
+};
+static_assert(sizeof(book_entry) == 24, "book_entry must stay 24 bytes: it is the file format");
+
+// Дебютная книга: записи отсортированы по ключу, ходы позиции находятся двоичным поиском.
+//
+// Формат файла: "CKBK", версия (uint32_t), число записей (uint64_t), затем записи book_entry.
+class OpeningBook
+{
+public:
+    // Загружает книгу из файла, false если файла нет или он повреждён
+    bool load(const string& path)
+    {
+        entries.clear();
+        ifstream fin(path, ios::binary);
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t count = 0;
+        fin.read(magic, sizeof(magic));
+        fin.read(reinterpret_cast<char*>(&version), sizeof(version));
+        fin.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!fin || memcmp(magic, "CKBK", 4) != 0 || version != book_version)
+            return false;
+        // число записей сверяется с размером файла до выделения памяти под них:
+        // испорченный заголовок не должен запросить гигабайты
+        const streamoff header_end = fin.tellg();
+        fin.seekg(0, ios::end);
+        const streamoff file_size = fin.tellg();
+        if (header_end < 0 || file_size < header_end ||
+            count != uint64_t(file_size - header_end) / sizeof(book_entry) ||
+            uint64_t(file_size - header_end) % sizeof(book_entry) != 0)
+            return false;
+        fin.seekg(header_end);
+        entries.resize(count);
+        fin.read(reinterpret_cast<char*>(entries.data()), streamsize(count * sizeof(book_entry)));
+        // ход читается из записи без проверок границ, поэтому повреждённая запись отвергает всю книгу
+        if (!fin || !all_of(entries.begin(), entries.end(), valid_entry))
+        {
+            entries.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Сохраняет книгу в файл (записи должны быть упорядочены finalize)
+    bool save(const string& path) const
+    {
+        ofstream fout(path, ios::binary | ios::trunc);
+        const uint64_t count = entries.size();
+        fout.write("CKBK", 4);
+        fout.write(reinterpret_cast<const char*>(&book_version), sizeof(book_version));
+        fout.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        fout.write(reinterpret_cast<const char*>(entries.data()), streamsize(count * sizeof(book_entry)));
+        return bool(fout);
+    }
+
+    // Добавляет ход line (шаги полного хода) из позиции с ключом key, false если ход слишком длинный
+    bool add(const uint64_t key, const vector<move_pos>& line, const uint32_t weight)
+    {
+        if (line.empty() || line.size() + 1 > sizeof(book_entry::path))
+            return false;
+        book_entry entry;
+        entry.key = key;
+        entry.weight = weight;
+        entry.length = uint8_t(line.size() + 1);
+        entry.path[0] = int8_t(Position::square(line.front().x, line.front().y));
+        for (size_t i = 0; i < line.size(); ++i)
+            entry.path[i + 1] = int8_t(Position::square(line[i].x2, line[i].y2));
+        entries.push_back(entry);
+        return true;
+    }
+
+    // Упорядочивает записи по ключу и складывает веса одинаковых ходов одной позиции;
+    // ходы с нулевым весом выбрасываются
+    void finalize()
+    {
+        sort(entries.begin(), entries.end(), [](const book_entry& a, const book_entry& b) {
+            if (a.key != b.key)
+                return a.key < b.key;
+            if (a.length != b.length)
+                return a.length < b.length;
+            return memcmp(a.path, b.path, a.length) < 0;
+        });
+        vector<book_entry> merged;
+        for (const auto& entry : entries)
+        {
+            if (!merged.empty() && merged.back().key == entry.key && same_move(merged.back(), entry))
+                merged.back().weight += entry.weight;
+            else
+                merged.push_back(entry);
+        }
+        merged.erase(remove_if(merged.begin(), merged.end(), [](const book_entry& e) { return e.weight == 0; }),
+                     merged.end());
+        entries.swap(merged);
+    }
+
+    // Ходы позиции с ключом key: диапазон [first, last), пустой если позиции нет в книге
+    pair<const book_entry*, const book_entry*> find(const uint64_t key) const
+    {
+        auto range = equal_range(entries.begin(), entries.end(), key, key_less());
+        return {entries.data() + (range.first - entries.begin()), entries.data() + (range.second - entries.begin())};
+    }
+
+    // Число записей
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+private:
+    // Запись пригодна: ход из хотя бы двух клеток доски и ненулевой вес (как после finalize)
+    static bool valid_entry(const book_entry& entry)
+    {
+        if (entry.weight == 0 || entry.length < 2 || entry.length > sizeof(entry.path))
+            return false;
+        return all_of(entry.path, entry.path + entry.length, [](const int8_t cell) { return cell >= 0 && cell < 32; });
+    }
+
+    static bool same_move(const book_entry& a, const book_entry& b)
+    {
+        return a.length == b.length && memcmp(a.path, b.path, a.length) == 0;
+    }
+
+    // Сравнение записи и ключа для двоичного поиска
+    struct key_less
+    {
+        bool operator()(const book_entry& entry, const uint64_t key) const
+        {
+            return entry.key < key;
+        }
+        bool operator()(const uint64_t key, const book_entry& entry) const
+        {
+            return key < entry.key;
+        }
+    };
+
+    static constexpr uint32_t book_version = 1;
+    vector<book_entry> entries;
+};
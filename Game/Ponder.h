@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Position.h"
+#include "Board_state.h"
+#include "Config.h"
+#include "Full_moves.h"
+#include "Logic.h"
+
+// Размышление бота на времени соперника (Bot.Ponder)
+//
+// Пока человек выбирает ход, в отдельном потоке перебираются его ответы: сначала предсказанный
+// (лучший ход человека по неглубокому поиску), затем остальные. Для каждого ответа бот ищет свой ход
+// на полную глубину уровня и запоминает его. Если человек сделал один из просчитанных ходов,
+// бот отвечает сразу; иначе обычный поиск идёт по уже наполненной таблице транспозиций.
+class Ponder
+{
+public:
+    // Параметры:
+    // - board: доска (фоновый поиск её не читает, позиция передаётся в start)
+    // - config: настройки игры (перечитываются в reset)
+    Ponder(BoardState* board, Config* config) : board(board), config(config)
+    {
+        reset();
+    }
+    Ponder(const Ponder&) = delete;
+    Ponder& operator=(const Ponder&) = delete;
+    ~Ponder()
+    {
+        stop();
+    }
+
+    // Пересоздаёт фоновый поиск по текущим настройкам (после config.reload())
+    void reset()
+    {
+        stop();
+        answers.clear();
+        ponder_config = *config;
+        // поиск ответа на фиксированную глубину уровня; таблицы берутся у основного бота в start
+        ponder_config.set("Bot", "MoveTimeMS", 0);
+        ponder_config.set("Bot", "HashMB", 0);
+        ponder_config.set("Bot", "TablebasePath", "");
+        ponder_config.set("Bot", "BookPath", "");
+        thinker = make_unique<Logic>(board, &ponder_config);
+    }
+
+    // Начинает размышление над позицией after (ходит соперник бота)
+    //
+    // Параметры:
+    // - main: основной бот, чьи таблицы наполняются
+    // - after: позиция после хода бота
+    // - depth: уровень бота (Max_depth)
+    void start(const Logic& main, const Position& after, const int depth)
+    {
+        stop();
+        answers.clear();
+        thinker->share_tables(main);
+        thinker->resume();
+        stopping.store(false);
+        worker = thread(&Ponder::run, this, after, depth);
+    }
+
+    // Останавливает размышление (ответы, найденные к этому моменту, сохраняются)
+    void stop()
+    {
+        if (!worker.joinable())
+            return;
+        stopping.store(true);
+        thinker->cancel();
+        worker.join();
+    }
+
+    // Останавливает размышление и возвращает готовый ответ для позиции pos (пусто, если его нет)
+    vector<move_pos> take(const Position& pos)
+    {
+        stop();
+        auto it = answers.find(pos.hash);
+        vector<move_pos> result = (it == answers.end() ? vector<move_pos>() : it->second);
+        answers.clear();
+        return result;
+    }
+
+private:
+    // Перебор ответов соперника (выполняется в потоке worker)
+    void run(Position pos, const int depth)
+    {
+        // предсказанный ответ: лучший ход соперника по неглубокому поиску
+        thinker->Max_depth = min(depth, 3);
+        const vector<move_pos> predicted = thinker->find_best_turns(pos);
+        if (stopping.load())
+            return;
+
+        // все ответы соперника, предсказанный первым
+        vector<Position> replies;
+        FullMoves moves;
+        moves.for_each(pos, [&](const Position& next, const vector<move_pos>& line) {
+            replies.push_back(next);
+            if (line == predicted)
+                std::swap(replies.front(), replies.back());
+        });
+
+        thinker->Max_depth = depth;
+        for (const Position& reply : replies)
+        {
+            if (!reply.pieces(reply.color))
+                continue; // у бота не осталось фигур, отвечать нечем
+            vector<move_pos> answer = thinker->find_best_turns(reply);
+            if (stopping.load())
+                return; // прерванный поиск недостоверен
+            if (!answer.empty())
+                answers[reply.hash] = std::move(answer);
+        }
+    }
+
+    BoardState* board;
+    Config* config;
+    // Копия настроек для фонового поиска
+    Config ponder_config = Config(*config);
+    // Бот, который ищет ответы в фоне (свои буферы, общие с основным ботом таблицы)
+    unique_ptr<Logic> thinker;
+    thread worker;
+    atomic<bool> stopping{false};
+    // Готовые ответы бота по ключу позиции после хода соперника
+    unordered_map<uint64_t, vector<move_pos>> answers;
+};
@@ -0,0 +1,259 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Эндшпильная база: результат каждой позиции с небольшим числом фигур при точной игре.
+//
+// Позиции разбиты на срезы по составу материала (белые шашки, чёрные шашки, белые дамки, чёрные дамки).
+// Внутри среза индекс позиции складывается из номеров сочетаний клеток каждой группы фигур
+// и очереди хода, значение занимает один байт (см. tb_value). Файл отображается в память
+// целиком, поэтому проба — это несколько арифметических операций и одно чтение.
+//
+// Формат файла: заголовок tb_header, затем смещения срезов (uint64_t, tb_no_slice для
+// отсутствующих) для всех сочетаний количеств от 0 до max_pieces, затем данные срезов.
+
+// Значение позиции для стороны, которой ходить
+// (расстояние считается в ходах обеих сторон, серия взятий — один ход):
+// - 0: ничья
+// - n = 1..127: выигрыш за n ходов (последний из них оставляет соперника без ходов)
+// - LOSS + n (n = 0..126): проигрыш через n ходов (LOSS — ходов нет уже сейчас)
+// - INVALID: позиция невозможна (фигуры на одной клетке, шашка на поле превращения)
+namespace tb_value
+{
+    const uint8_t DRAW = 0;
+    const uint8_t LOSS = 128;
+    const uint8_t INVALID = 255;
+    const int MAX_DISTANCE = 126;
+}
+
+struct tb_header
+{
+    char magic[4];       // "CKTB"
+    uint32_t version;    // Версия формата
+    uint32_t max_pieces; // Наибольшее число фигур в позиции
+    uint32_t reserved;
+};
+
+const uint32_t tb_version = 1;
+const uint64_t tb_no_slice = ~0ull;
+
+// Биномиальные коэффициенты C(n, k) для n <= 32, вычисляются при компиляции
+struct binomial_table
+{
+    uint64_t c[33][33];
+};
+
+constexpr binomial_table make_binomial_table()
+{
+    binomial_table t{};
+    for (int n = 0; n <= 32; ++n)
+    {
+        t.c[n][0] = 1;
+        for (int k = 1; k <= n; ++k)
+            t.c[n][k] = t.c[n - 1][k - 1] + (k <= n - 1 ? t.c[n - 1][k] : 0);
+    }
+    return t;
+}
+
+inline constexpr binomial_table binomial = make_binomial_table();
+
+class Tablebase
+{
+public:
+    Tablebase() = default;
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+    ~Tablebase()
+    {
+        close();
+    }
+
+    // Отображает файл базы в память, false если файла нет или он повреждён
+    bool open(const string& path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        size = size_t(file_size.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+            data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            size = size_t(st.st_size);
+            void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED)
+                data = static_cast<const uint8_t*>(addr);
+        }
+        ::close(fd); // отображение остаётся действительным и после закрытия файла
+#endif
+        if (!data || size < sizeof(tb_header))
+        {
+            close();
+            return false;
+        }
+        tb_header header;
+        memcpy(&header, data, sizeof(header));
+        const size_t table_bytes = slice_count(header.max_pieces) * sizeof(uint64_t);
+        if (memcmp(header.magic, "CKTB", 4) != 0 || header.version != tb_version || header.max_pieces > 8 ||
+            size < sizeof(tb_header) + table_bytes)
+        {
+            close();
+            return false;
+        }
+        max_pieces = int(header.max_pieces);
+        offsets = data + sizeof(tb_header);
+        // каждый срез, до которого может дойти probe, должен целиком лежать в файле:
+        // иначе обрезанный или испорченный файл приведёт к чтению за концом отображения посреди поиска
+        if (!slices_fit(sizeof(tb_header) + table_bytes))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data)
+            munmap(const_cast<uint8_t*>(data), size);
+#endif
+        data = nullptr;
+        offsets = nullptr;
+        size = 0;
+        max_pieces = 0;
+    }
+
+    // Наибольшее число фигур в позициях базы (0 — база не загружена)
+    int pieces() const
+    {
+        return max_pieces;
+    }
+
+    // Значение позиции для стороны pos.color (tb_value), false если позиции нет в базе
+    bool probe(const Position& pos, uint8_t& value) const
+    {
+        if (pop_count(pos.white | pos.black) > max_pieces || !pos.white || !pos.black)
+            return false;
+        uint64_t offset;
+        memcpy(&offset, offsets + slice_id(pos, max_pieces) * sizeof(uint64_t), sizeof(offset));
+        if (offset == tb_no_slice)
+            return false;
+        value = data[offset + index(pos)];
+        return value != tb_value::INVALID;
+    }
+
+    // Номер среза позиции в таблице смещений
+    static size_t slice_id(const Position& pos, const int max_pieces)
+    {
+        return slice_id(pop_count(pos.white & ~pos.kings), pop_count(pos.black & ~pos.kings),
+                        pop_count(pos.white & pos.kings), pop_count(pos.black & pos.kings), max_pieces);
+    }
+    static size_t slice_id(const int white_men, const int black_men, const int white_kings, const int black_kings,
+                           const int max_pieces)
+    {
+        const size_t n = size_t(max_pieces) + 1;
+        return ((size_t(white_men) * n + size_t(black_men)) * n + size_t(white_kings)) * n + size_t(black_kings);
+    }
+
+    // Число записей в таблице смещений
+    static size_t slice_count(const int max_pieces)
+    {
+        const size_t n = size_t(max_pieces) + 1;
+        return n * n * n * n;
+    }
+
+    // Число позиций в срезе (обе очереди хода)
+    static uint64_t slice_size(const int white_men, const int black_men, const int white_kings, const int black_kings)
+    {
+        return 2 * binomial.c[32][white_men] * binomial.c[32][black_men] * binomial.c[32][white_kings] *
+               binomial.c[32][black_kings];
+    }
+
+    // Индекс позиции внутри её среза
+    static uint64_t index(const Position& pos)
+    {
+        const uint32_t groups[4] = {pos.white & ~pos.kings, pos.black & ~pos.kings, pos.white & pos.kings,
+                                    pos.black & pos.kings};
+        uint64_t result = 0;
+        for (const uint32_t group : groups)
+            result = result * binomial.c[32][pop_count(group)] + combination_rank(group);
+        return result * 2 + pos.color;
+    }
+
+    // Номер сочетания клеток в колексикографическом порядке
+    static uint64_t combination_rank(uint32_t mask)
+    {
+        uint64_t rank = 0;
+        for (int i = 1; mask; mask &= mask - 1, ++i)
+            rank += binomial.c[lsb_index(mask)][i];
+        return rank;
+    }
+
+private:
+    // Все срезы с числом фигур не больше max_pieces лежат между таблицей смещений и концом файла
+    bool slices_fit(const size_t data_begin) const
+    {
+        for (int wm = 0; wm <= max_pieces; ++wm)
+            for (int bm = 0; wm + bm <= max_pieces; ++bm)
+                for (int wk = 0; wm + bm + wk <= max_pieces; ++wk)
+                    for (int bk = 0; wm + bm + wk + bk <= max_pieces; ++bk)
+                    {
+                        uint64_t offset;
+                        memcpy(&offset, offsets + slice_id(wm, bm, wk, bk, max_pieces) * sizeof(uint64_t),
+                               sizeof(offset));
+                        if (offset == tb_no_slice)
+                            continue;
+                        if (offset < data_begin || offset > size || slice_size(wm, bm, wk, bk) > size - offset)
+                            return false;
+                    }
+        return true;
+    }
+
+    const uint8_t* data = nullptr;
+    const uint8_t* offsets = nullptr;
+    size_t size = 0;
+    int max_pieces = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
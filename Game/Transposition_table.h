@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace std;
+
+// Тип сохранённой оценки
+enum class Bound : uint8_t
+{
+    EXACT, // Точная оценка
+    LOWER, // Оценка не меньше сохранённой (отсечение по beta)
+    UPPER  // Оценка не больше сохранённой (ни один ход не улучшил alpha)
+};
+
+// Запись таблицы транспозиций
+struct tt_entry
+{
+    uint64_t key = 0;           // Полный ключ позиции для проверки совпадения
+    double score = 0;           // Оценка позиции
+    int8_t from = -1, to = -1;  // Лучший ход (номера клеток Position), -1 если хода нет
+    uint8_t depth = 0;          // Оставшаяся глубина, с которой получена оценка
+    Bound bound = Bound::EXACT; // Тип оценки
+    uint8_t generation = 0;     // Номер поиска, в котором сделана запись
+};
+
+// Таблица транспозиций фиксированного размера (степень двойки) с заменой по глубине.
+//
+// Таблица общая для всех потоков поиска и работает без блокировок: запись хранится тремя
+// атомарными словами, а в первое слово вместо ключа кладётся key ^ score ^ data.
+// Если два потока пишут в одну ячейку одновременно, перемешанная запись не пройдёт проверку
+// ключа при чтении и будет просто проигнорирована.
+class TranspositionTable
+{
+public:
+    TranspositionTable() = default;
+    explicit TranspositionTable(const size_t size_mb)
+    {
+        resize(size_mb);
+    }
+
+    // Выделяет таблицу не больше size_mb мегабайт (0 отключает таблицу)
+    void resize(const size_t size_mb)
+    {
+        count = 0;
+        if (size_mb)
+        {
+            count = 1;
+            while (count * 2 * sizeof(slot) <= size_mb * 1024 * 1024)
+                count *= 2;
+        }
+        table.reset(count ? new slot[count] : nullptr);
+        mask = count ? count - 1 : 0;
+        clear();
+    }
+
+    // Очищает все записи
+    void clear()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            table[i].check.store(0, memory_order_relaxed);
+            table[i].score.store(0, memory_order_relaxed);
+            table[i].data.store(0, memory_order_relaxed);
+        }
+    }
+
+    // Начало нового поиска: записи прошлых поисков становятся кандидатами на замену
+    void new_search()
+    {
+        generation.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Поиск записи по ключу, false если позиция не сохранена
+    bool probe(const uint64_t key, tt_entry& entry) const
+    {
+        if (!count)
+            return false;
+        const slot& s = table[key & mask];
+        const uint64_t check = s.check.load(memory_order_relaxed);
+        const uint64_t score = s.score.load(memory_order_relaxed);
+        const uint64_t data = s.data.load(memory_order_relaxed);
+        if ((check ^ score ^ data) != key || !data)
+            return false;
+        unpack(key, score, data, entry);
+        return true;
+    }
+
+    // Сохраняет оценку: запись заменяется, если она пуста, устарела, принадлежит той же позиции
+    // или получена на меньшей глубине
+    void store(const uint64_t key, const double score, const Bound bound, const int depth, const int from, const int to)
+    {
+        if (!count)
+            return;
+        slot& s = table[key & mask];
+        const uint8_t current = generation.load(memory_order_relaxed);
+        tt_entry old;
+        const uint64_t old_score = s.score.load(memory_order_relaxed);
+        const uint64_t old_data = s.data.load(memory_order_relaxed);
+        const uint64_t old_key = s.check.load(memory_order_relaxed) ^ old_score ^ old_data;
+        unpack(old_key, old_score, old_data, old);
+        if (old_data && old_key != key && old.generation == current && old.depth > depth)
+            return;
+
+        tt_entry entry;
+        entry.from = int8_t(from);
+        entry.to = int8_t(to);
+        entry.depth = uint8_t(depth);
+        entry.bound = bound;
+        entry.generation = current;
+        uint64_t score_bits;
+        memcpy(&score_bits, &score, sizeof(score_bits));
+        const uint64_t data = pack(entry);
+        s.check.store(key ^ score_bits ^ data, memory_order_relaxed);
+        s.score.store(score_bits, memory_order_relaxed);
+        s.data.store(data, memory_order_relaxed);
+    }
+
+    // Количество записей
+    size_t size() const
+    {
+        return count;
+    }
+
+private:
+    // Ячейка таблицы
+    struct slot
+    {
+        atomic<uint64_t> check{0}; // key ^ score ^ data
+        atomic<uint64_t> score{0}; // Биты оценки (double)
+        atomic<uint64_t> data{0};  // Упакованные ход, глубина, тип оценки и поколение
+    };
+
+    // Упаковка служебных полей записи в одно слово (старший бит отмечает занятую ячейку)
+    static uint64_t pack(const tt_entry& entry)
+    {
+        return uint64_t(uint8_t(entry.from)) | uint64_t(uint8_t(entry.to)) << 8 | uint64_t(entry.depth) << 16 |
+               uint64_t(entry.bound) << 24 | uint64_t(entry.generation) << 32 | (1ull << 63);
+    }
+
+    static void unpack(const uint64_t key, const uint64_t score, const uint64_t data, tt_entry& entry)
+    {
+        entry.key = key;
+        memcpy(&entry.score, &score, sizeof(entry.score));
+        entry.from = int8_t(data & 0xFF);
+        entry.to = int8_t(data >> 8 & 0xFF);
+        entry.depth = uint8_t(data >> 16 & 0xFF);
+        entry.bound = Bound(data >> 24 & 0xFF);
+        entry.generation = uint8_t(data >> 32 & 0xFF);
+    }
+
+    unique_ptr<slot[]> table;
+    size_t count = 0;
+    size_t mask = 0;
+    atomic<uint8_t> generation{0};
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Счётчик выделений динамической памяти, используется для профилирования поиска
+inline std::atomic<size_t>& alloc_counter()
+{
+    static std::atomic<size_t> counter{0};
+    return counter;
+}
+
+// Текущее значение счётчика
+inline size_t alloc_count()
+{
+    return alloc_counter().load(std::memory_order_relaxed);
+}
+
+// При сборке с CHECKERS_COUNT_ALLOCS глобальный operator new считает каждое выделение.
+// Замена operator new должна попасть ровно в одну единицу трансляции (main.cpp).
+#ifdef CHECKERS_COUNT_ALLOCS
+void* operator new(std::size_t size)
+{
+    alloc_counter().fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include "Move.h"
+
+// Список ходов фиксированной вместимости без выделения памяти (живёт на стеке своего уровня поиска)
+//
+// Вместимость рассчитана на худший случай: ходы одной фигуры ведут на разные клетки её диагоналей,
+// а их не больше 13, поэтому 12 фигур дают не больше 156 ходов (взятия считаются по одному шагу серии).
+// Копирование переносит только занятую часть списка.
+class MoveList
+{
+public:
+    static constexpr size_t capacity = 160;
+
+    MoveList() = default;
+    MoveList(const MoveList& other) : beats(other.beats), count(other.count)
+    {
+        memcpy(storage, other.storage, count * sizeof(move_pos));
+    }
+    MoveList& operator=(const MoveList& other)
+    {
+        if (this == &other)
+            return *this;
+        count = other.count;
+        beats = other.beats;
+        memcpy(storage, other.storage, count * sizeof(move_pos));
+        return *this;
+    }
+
+    template <class... Args> void emplace_back(Args... args)
+    {
+        new (storage + count * sizeof(move_pos)) move_pos(args...);
+        ++count;
+    }
+    void push_back(const move_pos& turn)
+    {
+        emplace_back(turn);
+    }
+    void clear()
+    {
+        count = 0;
+        beats = false;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    move_pos* begin()
+    {
+        return data();
+    }
+    move_pos* end()
+    {
+        return data() + count;
+    }
+    const move_pos* begin() const
+    {
+        return data();
+    }
+    const move_pos* end() const
+    {
+        return data() + count;
+    }
+    move_pos& operator[](const size_t i)
+    {
+        return data()[i];
+    }
+    const move_pos& operator[](const size_t i) const
+    {
+        return data()[i];
+    }
+
+    // Все ходы списка — взятия (если взятие есть, другие ходы недопустимы)
+    bool beats = false;
+
+private:
+    move_pos* data()
+    {
+        return reinterpret_cast<move_pos*>(storage);
+    }
+    const move_pos* data() const
+    {
+        return reinterpret_cast<const move_pos*>(storage);
+    }
+
+    size_t count = 0;
+    alignas(move_pos) unsigned char storage[capacity * sizeof(move_pos)];
+};
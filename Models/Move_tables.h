@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+// Таблицы геометрии ходов для 32 тёмных клеток (нумерация как в Position: x * 4 + y / 2),
+// вычисляемые при компиляции. Направления: 0 — (-1, -1), 1 — (-1, +1), 2 — (+1, -1), 3 — (+1, +1)
+// по (строка, столбец); направления 0 и 1 ведут к меньшим номерам клеток, 2 и 3 — к большим.
+struct move_tables
+{
+    int8_t neighbour[32][4]; // Соседняя клетка по направлению (-1 — край доски)
+    int8_t jump_over[32][4]; // Клетка, через которую прыгает шашка при взятии (-1 — взятия нет)
+    int8_t jump_land[32][4]; // Клетка приземления при взятии шашкой (-1 — взятия нет)
+    uint32_t ray[32][4];     // Все клетки луча дамки по направлению до края доски
+};
+
+constexpr int dir_dx[4] = {-1, -1, 1, 1};
+constexpr int dir_dy[4] = {-1, 1, -1, 1};
+
+constexpr int table_square(const int x, const int y)
+{
+    return (x < 0 || x > 7 || y < 0 || y > 7) ? -1 : x * 4 + y / 2;
+}
+
+constexpr move_tables make_move_tables()
+{
+    move_tables t{};
+    for (int sq = 0; sq < 32; ++sq)
+    {
+        const int x = sq / 4, y = 2 * (sq % 4) + (x % 2 == 0);
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            t.neighbour[sq][dir] = int8_t(table_square(x + dir_dx[dir], y + dir_dy[dir]));
+            const int land = table_square(x + 2 * dir_dx[dir], y + 2 * dir_dy[dir]);
+            t.jump_over[sq][dir] = int8_t(land == -1 ? -1 : t.neighbour[sq][dir]);
+            t.jump_land[sq][dir] = int8_t(land);
+            t.ray[sq][dir] = 0;
+            for (int i = x + dir_dx[dir], j = y + dir_dy[dir]; table_square(i, j) != -1; i += dir_dx[dir], j += dir_dy[dir])
+                t.ray[sq][dir] |= 1u << table_square(i, j);
+        }
+    }
+    return t;
+}
+
+inline constexpr move_tables move_table = make_move_tables();
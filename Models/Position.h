@@ -0,0 +1,324 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Move.h"
+#include "Zobrist.h"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+// Количество установленных битов в маске
+inline int pop_count(uint32_t mask)
+{
+#ifdef _MSC_VER
+    return int(__popcnt(mask));
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+// Индекс младшего установленного бита (маска не должна быть пустой)
+inline int lsb_index(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Индекс старшего установленного бита (маска не должна быть пустой)
+inline int msb_index(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return int(index);
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+// Запись для отмены хода: что было сбито и произошло ли превращение в дамку
+struct move_undo
+{
+    uint32_t captured = 0;      // Бит сбитой фигуры (0 — хода без удара)
+    bool captured_king = false; // Сбитая фигура была дамкой
+    bool promoted = false;      // Шашка превратилась в дамку этим ходом
+    uint64_t hash = 0;          // Хеш позиции до хода
+    uint8_t advance[2] = {0, 0}; // Продвижение шашек до хода
+};
+
+// Компактное представление позиции для поиска: 32 тёмные клетки доски в виде битовых масок.
+// Клетка (x, y) с нечётной суммой координат получает номер x * 4 + y / 2,
+// поэтому обход битов по возрастанию совпадает с построчным обходом матрицы доски.
+struct Position
+{
+    uint32_t white = 0; // Белые фигуры (шашки и дамки)
+    uint32_t black = 0; // Чёрные фигуры (шашки и дамки)
+    uint32_t kings = 0; // Дамки обоих цветов
+    bool color = 0;     // Чей ход: 0 — белые, 1 — чёрные
+    uint64_t hash = 0;  // Ключ Zobrist, обновляется при каждом изменении позиции
+    // Продвижение шашек (не дамок) каждого цвета: сумма числа пройденных от своего края рядов,
+    // обновляется при каждом изменении позиции, чтобы оценка не обходила фигуры
+    uint8_t advance[2] = {0, 0};
+
+    Position() = default;
+
+    // Построение позиции из матрицы доски (коды фигур как в Board: 1, 2 — шашки, 3, 4 — дамки)
+    explicit Position(const std::vector<std::vector<POS_T>>& mtx, const bool color = 0) : color(color)
+    {
+        if (color)
+            hash ^= zobrist.side;
+        for (POS_T i = 0; i < 8; ++i)
+            for (POS_T j = 0; j < 8; ++j)
+                if (mtx[i][j])
+                    set(i, j, mtx[i][j]);
+    }
+
+    // Обратное преобразование в матрицу 8x8 для Board
+    std::vector<std::vector<POS_T>> to_matrix() const
+    {
+        std::vector<std::vector<POS_T>> mtx(8, std::vector<POS_T>(8, 0));
+        for (uint32_t mask = white | black; mask; mask &= mask - 1)
+        {
+            const int sq = lsb_index(mask);
+            mtx[row(sq)][col(sq)] = piece(sq);
+        }
+        return mtx;
+    }
+
+    // Номер клетки по координатам или -1 для светлых клеток и выхода за доску
+    static int square(const POS_T x, const POS_T y)
+    {
+        if (x < 0 || x > 7 || y < 0 || y > 7 || (x + y) % 2 == 0)
+            return -1;
+        return x * 4 + y / 2;
+    }
+
+    // Координаты клетки по её номеру
+    static POS_T row(const int sq)
+    {
+        return POS_T(sq / 4);
+    }
+    static POS_T col(const int sq)
+    {
+        return POS_T(2 * (sq % 4) + (sq / 4 % 2 == 0));
+    }
+
+    // Код фигуры на клетке с номером sq (0 — пусто)
+    POS_T piece(const int sq) const
+    {
+        const uint32_t bit = 1u << sq;
+        if (!((white | black) & bit))
+            return 0;
+        return POS_T(((black & bit) ? 2 : 1) + ((kings & bit) ? 2 : 0));
+    }
+
+    // Код фигуры по координатам доски
+    POS_T at(const POS_T x, const POS_T y) const
+    {
+        const int sq = square(x, y);
+        return sq == -1 ? 0 : piece(sq);
+    }
+
+    // Ставит фигуру с кодом type на клетку (x, y), type == 0 очищает клетку
+    void set(const POS_T x, const POS_T y, const POS_T type)
+    {
+        const int sq = square(x, y);
+        const uint32_t bit = 1u << sq;
+        if (const POS_T old = piece(sq))
+        {
+            hash ^= zobrist.piece[old - 1][sq];
+            if (old <= 2)
+                advance[old - 1] -= advance_of(old == 2, sq);
+        }
+        if (type)
+            hash ^= zobrist.piece[type - 1][sq];
+        if (type && type <= 2)
+            advance[type - 1] += advance_of(type == 2, sq);
+        white &= ~bit;
+        black &= ~bit;
+        kings &= ~bit;
+        if (!type)
+            return;
+        if (type % 2)
+            white |= bit;
+        else
+            black |= bit;
+        if (type > 2)
+            kings |= bit;
+    }
+
+    // Название клетки в алгебраической нотации: вертикали a–h слева направо, горизонтали 1–8 от белых
+    static std::string square_name(const int sq)
+    {
+        return std::string(1, char('a' + col(sq))) + char('8' - row(sq));
+    }
+
+    // Номер клетки по алгебраическому названию или -1, если это не тёмная клетка доски
+    static int square_by_name(const std::string& name)
+    {
+        if (name.size() != 2 || name[0] < 'a' || name[0] > 'h' || name[1] < '1' || name[1] > '8')
+            return -1;
+        return square(POS_T('8' - name[1]), POS_T(name[0] - 'a'));
+    }
+
+    // Позиция из строки FEN в формате PDN для русских шашек: "W:Wc1,Ke3:Bb8,d6",
+    // первая буква — чей ход, затем списки белых и чёрных фигур (K — дамка)
+    static Position from_fen(const std::string& fen)
+    {
+        if (fen.size() < 2 || (fen[0] != 'W' && fen[0] != 'B') || fen[1] != ':')
+            throw std::runtime_error("bad FEN: " + fen);
+        Position pos;
+        if (fen[0] == 'B')
+            pos.pass_turn();
+        size_t begin = 2;
+        while (begin < fen.size())
+        {
+            size_t end = fen.find(':', begin);
+            if (end == std::string::npos)
+                end = fen.size();
+            const char side = fen[begin];
+            if (side != 'W' && side != 'B')
+                throw std::runtime_error("bad FEN: " + fen);
+            // Список фигур одного цвета через запятую
+            for (size_t item = begin + 1; item < end;)
+            {
+                size_t next = fen.find(',', item);
+                if (next == std::string::npos || next > end)
+                    next = end;
+                std::string name = fen.substr(item, next - item);
+                const bool king = !name.empty() && name[0] == 'K';
+                const int sq = square_by_name(king ? name.substr(1) : name);
+                if (sq == -1)
+                    throw std::runtime_error("bad FEN square: " + name);
+                pos.set(row(sq), col(sq), POS_T((side == 'W' ? 1 : 2) + (king ? 2 : 0)));
+                item = next + 1;
+            }
+            begin = end + 1;
+        }
+        return pos;
+    }
+
+    // Запись позиции в формате FEN (обратное к from_fen)
+    std::string to_fen() const
+    {
+        std::string fen(1, color ? 'B' : 'W');
+        for (const bool side : {false, true})
+        {
+            fen += side ? ":B" : ":W";
+            for (uint32_t mask = pieces(side); mask; mask &= mask - 1)
+            {
+                const int sq = lsb_index(mask);
+                if (mask != pieces(side))
+                    fen += ',';
+                if (kings & (1u << sq))
+                    fen += 'K';
+                fen += square_name(sq);
+            }
+        }
+        return fen;
+    }
+
+    // Продвижение шашки цвета side, стоящей на клетке sq
+    static int advance_of(const bool side, const int sq)
+    {
+        return side ? row(sq) : 7 - row(sq);
+    }
+
+    // Фигуры указанного цвета
+    uint32_t pieces(const bool side) const
+    {
+        return side ? black : white;
+    }
+
+    // Выполняет ход на месте, сохраняя в undo всё необходимое для отмены
+    // (очередь хода не меняется: серия взятий продолжается тем же игроком)
+    void do_move(const move_pos& turn, move_undo& undo)
+    {
+        const int from_sq = square(turn.x, turn.y), to_sq = square(turn.x2, turn.y2);
+        const uint32_t from = 1u << from_sq;
+        const uint32_t to = 1u << to_sq;
+        const bool is_white = (white & from) != 0;
+        uint32_t& own = is_white ? white : black;
+        uint32_t& other = is_white ? black : white;
+        const POS_T type = piece(from_sq);
+
+        undo.hash = hash;
+        undo.advance[0] = advance[0];
+        undo.advance[1] = advance[1];
+        undo.captured = 0;
+        undo.captured_king = false;
+        if (turn.xb != -1) // Снимаем сбитую фигуру
+        {
+            const int captured_sq = square(turn.xb, turn.yb);
+            hash ^= zobrist.piece[piece(captured_sq) - 1][captured_sq];
+            undo.captured = 1u << captured_sq;
+            undo.captured_king = (kings & undo.captured) != 0;
+            if (!undo.captured_king)
+                advance[is_white] -= advance_of(is_white, captured_sq);
+            other &= ~undo.captured;
+            kings &= ~undo.captured;
+        }
+        own ^= from | to;
+        undo.promoted = false;
+        if (kings & from)
+            kings ^= from | to;
+        else
+        {
+            advance[!is_white] -= advance_of(!is_white, from_sq);
+            if ((is_white && turn.x2 == 0) || (!is_white && turn.x2 == 7)) // Шашка дошла до края поля
+            {
+                kings |= to;
+                undo.promoted = true;
+            }
+            else
+                advance[!is_white] += advance_of(!is_white, to_sq);
+        }
+        hash ^= zobrist.piece[type - 1][from_sq] ^ zobrist.piece[type + 2 * undo.promoted - 1][to_sq];
+    }
+
+    // Отменяет ход, выполненный do_move с той же записью undo
+    void undo_move(const move_pos& turn, const move_undo& undo)
+    {
+        const uint32_t from = 1u << square(turn.x, turn.y);
+        const uint32_t to = 1u << square(turn.x2, turn.y2);
+        const bool is_white = (white & to) != 0;
+        uint32_t& own = is_white ? white : black;
+        uint32_t& other = is_white ? black : white;
+
+        if (undo.promoted)
+            kings &= ~to;
+        else if (kings & to)
+            kings ^= from | to;
+        own ^= from | to;
+        if (undo.captured) // Возвращаем сбитую фигуру
+        {
+            other |= undo.captured;
+            if (undo.captured_king)
+                kings |= undo.captured;
+        }
+        hash = undo.hash;
+        advance[0] = undo.advance[0];
+        advance[1] = undo.advance[1];
+    }
+
+    // Передача хода сопернику
+    void pass_turn()
+    {
+        color = !color;
+        hash ^= zobrist.side;
+    }
+
+    bool operator==(const Position& other) const
+    {
+        return white == other.white && black == other.black && kings == other.kings && color == other.color;
+    }
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+// Счётчики одного поиска хода (Logic::stats)
+//
+// Вспомогательные потоки считают свои счётчики, основной поток складывает их в конце поиска (merge).
+struct SearchStats
+{
+    static constexpr size_t cutoff_buckets = 8; // Отсечения по номеру хода: 0, 1, ..., 6 и 7 и дальше
+
+    uint64_t nodes = 0;          // Посещённые узлы
+    uint64_t qnodes = 0;         // Из них узлы форсированного продления взятий
+    uint64_t tt_probes = 0;      // Обращения к таблице транспозиций
+    uint64_t tt_hits = 0;        // Найденные в ней позиции
+    uint64_t tt_cutoffs = 0;     // Узлы, оценка которых взята из таблицы без поиска
+    uint64_t cutoffs = 0;        // Отсечения альфа-бета
+    std::array<uint64_t, cutoff_buckets> cutoffs_by_move{}; // Отсечения по номеру хода, давшего отсечение
+    uint64_t tablebase_hits = 0; // Позиции, оценка которых взята из эндшпильной базы
+    uint64_t researches = 0;     // Пересчёты с полным окном ходов, превзошедших alpha в нулевом окне
+    uint64_t aspiration_fails = 0; // Выходы оценки корня за окно аспирации
+    int depth = -1;              // Глубина последней завершённой итерации (-1 — поиска не было)
+    double score = 0;            // Оценка корня этой итерации со стороны ходящего (см. Logic::to_value)
+    int seldepth = 0;            // Наибольшая достигнутая глубина рекурсии (с продлениями взятий)
+    double time_ms = 0;          // Время поиска
+    bool book = false;           // Ход взят из дебютной книги
+
+    // Учитывает счётчики вспомогательного потока
+    void merge(const SearchStats& other)
+    {
+        nodes += other.nodes;
+        qnodes += other.qnodes;
+        tt_probes += other.tt_probes;
+        tt_hits += other.tt_hits;
+        tt_cutoffs += other.tt_cutoffs;
+        cutoffs += other.cutoffs;
+        for (size_t i = 0; i < cutoff_buckets; ++i)
+            cutoffs_by_move[i] += other.cutoffs_by_move[i];
+        tablebase_hits += other.tablebase_hits;
+        researches += other.researches;
+        aspiration_fails += other.aspiration_fails;
+        seldepth = std::max(seldepth, other.seldepth);
+    }
+
+    // Учитывает отсечение на ходе с номером index в упорядоченном списке
+    void add_cutoff(const size_t index)
+    {
+        ++cutoffs;
+        ++cutoffs_by_move[std::min(index, cutoff_buckets - 1)];
+    }
+
+    // Эффективный коэффициент ветвления: такое b, что b^(число полуходов) равно числу узлов
+    double branching_factor() const
+    {
+        if (depth < 0 || nodes == 0)
+            return 0;
+        return std::pow(double(nodes), 1.0 / (depth + 1)); // итерация глубины d просматривает d + 1 полуход
+    }
+
+    // Узлов в секунду
+    uint64_t nps() const
+    {
+        return time_ms > 0 ? uint64_t(nodes * 1000.0 / time_ms) : 0;
+    }
+
+    // Доля отсечений на первом же ходе в процентах (показатель качества упорядочивания)
+    uint64_t first_move_cutoff_percent() const
+    {
+        return cutoffs ? 100 * cutoffs_by_move[0] / cutoffs : 0;
+    }
+
+    // Все счётчики одной строкой JSON (для журнала статистики Bot.StatsLog)
+    nlohmann::json to_json() const
+    {
+        return {{"nodes", nodes},
+                {"qnodes", qnodes},
+                {"tt_probes", tt_probes},
+                {"tt_hits", tt_hits},
+                {"tt_cutoffs", tt_cutoffs},
+                {"cutoffs", cutoffs},
+                {"cutoffs_by_move", cutoffs_by_move},
+                {"tablebase_hits", tablebase_hits},
+                {"researches", researches},
+                {"aspiration_fails", aspiration_fails},
+                {"depth", depth},
+                {"score", score},
+                {"seldepth", seldepth},
+                {"ebf", branching_factor()},
+                {"time_ms", time_ms},
+                {"nps", nps()},
+                {"book", book}};
+    }
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+// Ключи Zobrist для хеширования позиций: по ключу на каждый тип фигуры (код 1..4) на каждой из 32 клеток
+// и ключ очереди хода
+struct zobrist_keys
+{
+    uint64_t piece[4][32];
+    uint64_t side;
+};
+
+// Генератор splitmix64: детерминированные псевдослучайные ключи, вычисляемые при компиляции
+constexpr uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+constexpr zobrist_keys make_zobrist_keys()
+{
+    zobrist_keys keys{};
+    uint64_t state = 0x436865636B657273ull;
+    for (int type = 0; type < 4; ++type)
+        for (int sq = 0; sq < 32; ++sq)
+            keys.piece[type][sq] = splitmix64(state);
+    keys.side = splitmix64(state);
+    return keys;
+}
+
+inline constexpr zobrist_keys zobrist = make_zobrist_keys();
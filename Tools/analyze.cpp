@@ -0,0 +1,243 @@
+// Пакетный анализ позиций без окна.
+//
+// Читает позиции в формате FEN по одной в строке (из файла или stdin), ищет лучший ход каждой
+// на пуле потоков и выводит по строке JSON на позицию строго в порядке ввода, по мере готовности:
+//   {"index":0,"fen":"W:...","move":"c3-d4","score":0.08,"pv":["c3-d4","f6-g5"],"depth":8,"nodes":51234,"time_ms":3.1}
+// score — оценка со стороны ходящего (натуральный логарифм отношения сил, см. Logic::to_value):
+// 0 — равенство, около 20.7 — выигрыш, около -20.7 — проигрыш. pv — лучший ход и его продолжение
+// по таблице транспозиций. Если ходить нечем, move и score равны null; строка с ошибкой FEN
+// получает поле "error". Пустые строки и строки с '#' в начале пропускаются, после FEN
+// через пробел может идти что угодно (комментарий).
+//
+// Каждый поток ищет в один поток поиска (параллельность — это сами позиции) со своей позицией,
+// таблица транспозиций и эндшпильная база у всех общие (поэтому из равноценных ходов от запуска
+// к запуску может выбираться разный: таблица хранит оценки уже разобранных позиций).
+// В обработке одновременно не больше 64 позиций на поток, поэтому память не растёт с размером входа.
+// Остальные настройки бота (оценка, продление взятий, размер таблицы) берутся из settings.json;
+// дебютная книга не используется: ход из книги не даёт оценки.
+//
+// Использование:
+//   checkers_analyze [input.txt] [--depth D] [--time MS] [--threads T] [--settings settings.json]
+// --time задаёт бюджет времени на позицию (углубление до D, пока хватает времени), 0 — поиск сразу на D.
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Full_moves.h"
+#include "../Game/Logic.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Позиция из входа с её номером
+struct analyze_job
+{
+    size_t index;
+    string fen;
+};
+
+// Пул потоков анализа с выводом результатов в порядке поступления позиций
+class Analyzer
+{
+public:
+    Analyzer(Config* config, const int depth, const unsigned threads) : window(size_t(threads) * 64)
+    {
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            workers.push_back(make_unique<Worker>(config, depth));
+            if (i != 0)
+                workers[i]->logic.share_tables(workers[0]->logic); // одна таблица и база на весь пул
+        }
+        for (auto& worker : workers)
+            worker->thread = std::thread(&Analyzer::work, this, worker.get());
+    }
+
+    // Ставит позицию в очередь; ждёт, пока число позиций в обработке не станет меньше окна
+    void submit(const string& fen)
+    {
+        unique_lock<mutex> lock(guard);
+        space.wait(lock, [this]() { return submitted - written < window; });
+        jobs.push({submitted++, fen});
+        pending.notify_one();
+    }
+
+    // Дожидается анализа всех поставленных позиций и останавливает потоки
+    void finish()
+    {
+        {
+            lock_guard<mutex> lock(guard);
+            closed = true;
+        }
+        pending.notify_all();
+        for (auto& worker : workers)
+            worker->thread.join();
+        fflush(stdout);
+    }
+
+private:
+    struct Worker
+    {
+        Worker(Config* config, const int depth) : logic(&board, config)
+        {
+            logic.Max_depth = depth;
+        }
+
+        BoardState board; // Поиск идёт по позиции, доска нужна только конструктору Logic
+        Logic logic;
+        FullMoves moves;
+        std::thread thread;
+    };
+
+    void work(Worker* worker)
+    {
+        while (true)
+        {
+            analyze_job job;
+            {
+                unique_lock<mutex> lock(guard);
+                pending.wait(lock, [this]() { return closed || !jobs.empty(); });
+                if (jobs.empty())
+                    return;
+                job = move(jobs.front());
+                jobs.pop();
+            }
+            string line = analyze(*worker, job).dump();
+            line += '\n';
+
+            // выводим все результаты, готовые по порядку
+            lock_guard<mutex> lock(guard);
+            done.emplace(job.index, move(line));
+            bool wrote = false;
+            for (auto it = done.begin(); it != done.end() && it->first == written; it = done.erase(it))
+            {
+                fwrite(it->second.data(), 1, it->second.size(), stdout);
+                ++written;
+                wrote = true;
+            }
+            if (wrote)
+            {
+                fflush(stdout);
+                space.notify_one();
+            }
+        }
+    }
+
+    // Анализ одной позиции
+    static nlohmann::json analyze(Worker& worker, const analyze_job& job)
+    {
+        nlohmann::json result = {{"index", job.index}, {"fen", job.fen}};
+        Position pos;
+        try
+        {
+            pos = Position::from_fen(job.fen);
+        }
+        catch (const exception& e)
+        {
+            result["error"] = e.what();
+            return result;
+        }
+        const vector<move_pos> best = worker.logic.find_best_turns(pos);
+        const SearchStats& stats = worker.logic.stats;
+        if (best.empty())
+        {
+            result["move"] = nullptr; // ходить нечем — ходящий проиграл
+            result["score"] = nullptr;
+            result["pv"] = nlohmann::json::array();
+        }
+        else
+        {
+            result["move"] = FullMoves::notation(best);
+            result["score"] = stats.score;
+            const size_t length = size_t(max(stats.depth, 0)) + 1; // не длиннее глубины поиска
+            result["pv"] = worker.moves.principal_variation(worker.logic, pos, best, length);
+        }
+        result["depth"] = stats.depth;
+        result["nodes"] = stats.nodes;
+        result["time_ms"] = stats.time_ms;
+        return result;
+    }
+
+    vector<unique_ptr<Worker>> workers;
+    const size_t window; // Наибольшее число позиций в обработке
+
+    mutex guard;
+    condition_variable pending; // Появилась позиция или вход закончился
+    condition_variable space;   // Освободилось место в окне
+    queue<analyze_job> jobs;
+    map<size_t, string> done; // Готовые строки, ждущие вывода более ранних позиций
+    size_t submitted = 0;     // Номер следующей позиции входа
+    size_t written = 0;       // Число выведенных строк
+    bool closed = false;      // Вход закончился
+};
+
+int main(int argc, char* argv[])
+{
+    string input, settings;
+    int depth = 8, time_ms = 0;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i)
+    {
+        const string option = argv[i];
+        if (option.rfind("--", 0) != 0 && input.empty())
+            input = option;
+        else if (option == "--depth" && i + 1 < argc)
+            depth = max(1, atoi(argv[++i]));
+        else if (option == "--time" && i + 1 < argc)
+            time_ms = max(0, atoi(argv[++i]));
+        else if (option == "--threads" && i + 1 < argc)
+            threads = max(1, atoi(argv[++i]));
+        else if (option == "--settings" && i + 1 < argc)
+            settings = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [input.txt] [--depth D] [--time MS] [--threads T] [--settings settings.json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    ifstream file;
+    if (!input.empty())
+    {
+        file.open(input);
+        if (!file)
+        {
+            fprintf(stderr, "cannot open %s\n", input.c_str());
+            return 1;
+        }
+    }
+    istream& in = input.empty() ? cin : file;
+
+    Config config = settings.empty() ? Config() : Config(settings);
+    config.set("Bot", "MoveTimeMS", time_ms);
+    config.set("Bot", "Threads", 1);
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "BookPath", "");
+
+    Analyzer analyzer(&config, depth, threads);
+    string line;
+    while (getline(in, line))
+    {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == string::npos || line[begin] == '#')
+            continue;
+        const size_t end = line.find_first_of(" \t\r", begin);
+        analyzer.submit(line.substr(begin, end == string::npos ? string::npos : end - begin));
+    }
+    analyzer.finish();
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Арена: турнир бот против бота без окна.
+//
+// Две конфигурации движка (файлы в формате settings.json) играют пары партий из одинаковых
+// случайных дебютов со сменой цвета. Партии идут параллельно на всех ядрах.
+// Бот играет с уровнем своего цвета из своего файла (WhiteBotLevel / BlackBotLevel)
+// и с одним потоком поиска: параллельность арены — это сами партии.
+//
+// Использование:
+//   checkers_arena <settings_a.json> <settings_b.json> [--games N] [--threads T] [--opening-plies K] [--seed S]
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Logic.h"
+#include "../Game/Match.h"
+
+using namespace std;
+
+// Разница Эло по доле набранных очков
+double elo_from_score(const double score)
+{
+    const double p = min(max(score, 1e-6), 1 - 1e-6);
+    return -400.0 * log10(1.0 / p - 1.0);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <settings_a.json> <settings_b.json> [--games N] [--threads T] [--opening-plies K] [--seed S]\n",
+                argv[0]);
+        return 1;
+    }
+    Config config_a(argv[1]), config_b(argv[2]);
+    int games = 1000;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    int opening_plies = 4;
+    unsigned seed = 1;
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        const string option = argv[i];
+        if (option == "--games")
+            games = atoi(argv[i + 1]);
+        else if (option == "--threads")
+            threads = max(1, atoi(argv[i + 1]));
+        else if (option == "--opening-plies")
+            opening_plies = atoi(argv[i + 1]);
+        else if (option == "--seed")
+            seed = unsigned(atoi(argv[i + 1]));
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+    config_a.set("Bot", "Threads", 1);
+    config_b.set("Bot", "Threads", 1);
+    const int max_turns = config_a("Game", "MaxNumTurns");
+
+    // Счёт с точки зрения движка A
+    atomic<int> next_pair{0}, wins{0}, draws{0}, losses{0};
+    auto worker = [&]() {
+        BoardState board;
+        Logic engine_a(&board, &config_a), engine_b(&board, &config_b);
+        for (int pair = next_pair++; 2 * pair < games; pair = next_pair++)
+        {
+            for (int game = 0; game < 2 && 2 * pair + game < games; ++game)
+            {
+                const bool a_is_white = (game == 0);
+                Logic* white = a_is_white ? &engine_a : &engine_b;
+                Logic* black = a_is_white ? &engine_b : &engine_a;
+                const int white_level = (a_is_white ? config_a : config_b)("Bot", "WhiteBotLevel");
+                const int black_level = (a_is_white ? config_b : config_a)("Bot", "BlackBotLevel");
+                Match match(&board, white, black, white_level, black_level, max_turns);
+
+                // обе партии пары начинаются с одного и того же случайного дебюта
+                board.reset();
+                mt19937 rng(seed * 1000003u + unsigned(pair));
+                const int first_turn = match.random_opening(opening_plies, rng);
+                if (first_turn == -1)
+                    continue; // дебют закончил партию, такую пару не считаем
+                const int result = match.play(first_turn);
+                if (result == 0)
+                    ++draws;
+                else if ((result == 1) == a_is_white)
+                    ++wins;
+                else
+                    ++losses;
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 0; i < threads; ++i)
+        pool.emplace_back(worker);
+    for (auto& th : pool)
+        th.join();
+
+    const int total = wins + draws + losses;
+    if (total == 0)
+    {
+        fprintf(stderr, "no games played\n");
+        return 1;
+    }
+    // Доля очков и её стандартная ошибка по распределению исходов отдельных партий
+    const double score = (wins + 0.5 * draws) / total;
+    const double variance = (wins * pow(1 - score, 2) + draws * pow(0.5 - score, 2) + losses * pow(score, 2)) / total;
+    const double margin = 1.96 * sqrt(variance / total);
+    printf("Games: %d  A wins: %d  draws: %d  A losses: %d\n", total, wins.load(), draws.load(), losses.load());
+    printf("Score of A: %.1f%%  Elo difference: %+.1f  95%% CI: [%+.1f, %+.1f]\n", 100 * score, elo_from_score(score),
+           elo_from_score(score - margin), elo_from_score(score + margin));
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Построение дебютной книги (Game/Opening_book.h).
+//
+// Два способа:
+// - search: обходит все позиции до глубины plies полных ходов от начальной расстановки
+//   и записывает для каждой лучший ход поиска на уровне depth;
+// - selfplay: играет партии бот против бота из случайных дебютов (как checkers_arena)
+//   и записывает ходы первых plies полных ходов с весом по результату для сделавшей ход стороны:
+//   2 за победу, 1 за ничью, 0 за поражение.
+// Настройки бота (оценка, таблица транспозиций, уровни для selfplay) берутся из settings.json.
+//
+// Использование:
+//   checkers_bookgen <output.book> search [--plies P] [--depth D]
+//   checkers_bookgen <output.book> selfplay [--games N] [--plies P] [--opening-plies K] [--threads T] [--seed S]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Full_moves.h"
+#include "../Game/Logic.h"
+#include "../Game/Match.h"
+#include "../Game/Opening_book.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Обход дерева дебюта с поиском лучшего хода в каждой позиции
+class SearchBuilder
+{
+public:
+    SearchBuilder(Config* config, OpeningBook* book, const int plies, const int depth)
+        : logic(&board, config), book(book), plies(plies)
+    {
+        logic.Max_depth = depth;
+    }
+
+    void run()
+    {
+        board.reset();
+        Position pos(board.get_board(), 0);
+        visit(pos, 0);
+    }
+
+private:
+    void visit(Position& pos, const int ply)
+    {
+        if (ply == plies || !visited.insert(pos.hash).second)
+            return;
+        board.set_board(pos.to_matrix());
+        const vector<move_pos> best = logic.find_best_turns(pos.color);
+        if (best.empty())
+            return;
+        book->add(pos.hash, best, 1);
+        if (visited.size() % 100 == 0)
+        {
+            printf("%zu positions\n", visited.size());
+            fflush(stdout);
+        }
+        moves.for_each(pos, [&](const Position&, const vector<move_pos>&) { visit(pos, ply + 1); });
+    }
+
+    BoardState board;
+    Logic logic;
+    FullMoves moves;
+    OpeningBook* book;
+    int plies;
+    unordered_set<uint64_t> visited;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || (string(argv[2]) != "search" && string(argv[2]) != "selfplay"))
+    {
+        fprintf(stderr,
+                "usage: %s <output.book> search [--plies P] [--depth D]\n"
+                "       %s <output.book> selfplay [--games N] [--plies P] [--opening-plies K] [--threads T] [--seed S]\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+    const string mode = argv[2];
+    int plies = mode == "search" ? 4 : 8, depth = 10, games = 1000, opening_plies = 2;
+    unsigned threads = max(1u, thread::hardware_concurrency()), seed = 1;
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        const string option = argv[i];
+        if (option == "--plies")
+            plies = atoi(argv[i + 1]);
+        else if (option == "--depth")
+            depth = atoi(argv[i + 1]);
+        else if (option == "--games")
+            games = atoi(argv[i + 1]);
+        else if (option == "--opening-plies")
+            opening_plies = atoi(argv[i + 1]);
+        else if (option == "--threads")
+            threads = max(1, atoi(argv[i + 1]));
+        else if (option == "--seed")
+            seed = unsigned(atoi(argv[i + 1]));
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+
+    Config config;
+    // книга строится поиском на фиксированную глубину, без случайности и без старой книги
+    config.set("Bot", "MoveTimeMS", 0);
+    config.set("Bot", "BookPath", "");
+    OpeningBook book;
+    if (mode == "search")
+    {
+        config.set("Bot", "NoRandom", true);
+        SearchBuilder builder(&config, &book, plies, depth);
+        builder.run();
+    }
+    else
+    {
+        config.set("Bot", "Threads", 1);
+        const int max_turns = config("Game", "MaxNumTurns");
+        const int white_level = config("Bot", "WhiteBotLevel");
+        const int black_level = config("Bot", "BlackBotLevel");
+        atomic<int> next_game{0};
+        mutex book_mutex;
+        auto worker = [&]() {
+            BoardState board;
+            Logic white(&board, &config), black(&board, &config);
+            for (int game = next_game++; game < games; game = next_game++)
+            {
+                Match match(&board, &white, &black, white_level, black_level, max_turns);
+                board.reset();
+                mt19937 rng(seed * 1000003u + unsigned(game));
+                if (match.random_opening(opening_plies, rng) == -1)
+                    continue;
+                const int result = match.play(opening_plies);
+
+                // проходим партию заново, чтобы получить ключи позиций
+                board.reset();
+                Position pos(board.get_board(), 0);
+                lock_guard<mutex> lock(book_mutex);
+                for (size_t ply = 0; ply < match.moves.size() && ply < size_t(plies); ++ply)
+                {
+                    const bool color = pos.color;
+                    const uint32_t weight = result == 0 ? 1 : (result == 1) == (color == 0) ? 2 : 0;
+                    book.add(pos.hash, match.moves[ply], weight);
+                    for (const move_pos& turn : match.moves[ply])
+                    {
+                        move_undo undo;
+                        pos.do_move(turn, undo);
+                    }
+                    pos.pass_turn();
+                }
+                if ((game + 1) % 100 == 0)
+                {
+                    printf("%d games\n", game + 1);
+                    fflush(stdout);
+                }
+            }
+        };
+        vector<thread> pool;
+        for (unsigned i = 0; i < threads; ++i)
+            pool.emplace_back(worker);
+        for (auto& th : pool)
+            th.join();
+    }
+
+    book.finalize();
+    if (!book.save(argv[1]))
+    {
+        fprintf(stderr, "can't write %s\n", argv[1]);
+        return 1;
+    }
+    printf("%zu book moves written to %s\n", book.size(), argv[1]);
+    return 0;
+}
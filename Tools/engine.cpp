@@ -0,0 +1,627 @@
+// Движок без окна: текстовый протокол в стиле UCI поверх stdin/stdout или UNIX-сокета.
+//
+// Процесс живёт долго и держит таблицу транспозиций, эндшпильную базу и дебютную книгу в памяти,
+// поэтому запросу не нужно ждать их загрузки. Через сокет одновременно работают несколько сессий,
+// у каждой свои позиция, настройки поиска и поток поиска; таблицы общие для всех.
+//
+// Команды (по одной в строке):
+//   uci                                      id, список настроек, uciok
+//   isready                                  readyok
+//   setoption name <Key> value <V>           настройка из раздела Bot файла settings.json
+//   ucinewgame                               начальная расстановка
+//   position startpos|fen <FEN> [moves <m1> <m2> ...]
+//   go [depth D] [movetime MS] [infinite] [ponder]
+//   stop                                     прервать поиск и выдать ход
+//   ponderhit                                соперник сделал предсказанный ход: поиск продолжается с бюджетом movetime
+//   quit
+// Ходы записываются как "c3-d4" и "c3:e5:g3" (серия взятий целиком). Ответ на go — строка
+//   info depth D score cp S nodes N nps X time T pv <ходы>
+// и затем bestmove <ход> [ponder <ход>]; score cp — оценка со стороны ходящего
+// (логарифм отношения сил, см. Logic::to_value) × 100. После go infinite и go ponder
+// bestmove выдаётся только по stop или ponderhit.
+// go без depth и movetime ищет с бюджетом MoveTimeMS (0 — до stop); depth без movetime — до глубины D.
+// HashMB, TablebasePath и BookPath меняют таблицы всех сессий: начатые поиски доживают на старых.
+// Сессии с разными BotScoringType и Quiescence делят таблицу транспозиций, но не видят записей
+// друг друга (ключ учитывает способ оценки, см. Logic::evaluation_salt).
+//
+// Использование:
+//   checkers_engine [--socket PATH] [--settings settings.json]
+// Без --socket протокол идёт через stdin/stdout, с --socket — через соединения с сокетом PATH.
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+    #include <csignal>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Full_moves.h"
+#include "../Game/Logic.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Наибольшая глубина поиска, если go её не задаёт (поиск ограничен временем или stop)
+const int max_search_depth = 64;
+// Бюджет времени поиска «до stop»: Logic углубляет поиск по итерациям, только если бюджет задан
+const unsigned int unlimited_ms = 1u << 31;
+
+// Настройка протокола, соответствующая ключу раздела Bot
+struct engine_option
+{
+    const char* name;
+    const char* type;  // check, spin, combo или string
+    const char* range; // Допустимые значения в записи UCI
+    const char* absent; // Значение для ответа на uci, если ключа нет в settings.json (умолчание Logic и go)
+    bool shared;       // Настройка общих таблиц, а не сессии
+};
+const engine_option engine_options[] = {
+    {"BotScoringType", "combo", "var NumberOnly var NumberAndPotential", "NumberOnly", false},
+    {"Optimization", "combo", "var O0 var O1 var O2", "O1", false},
+    {"Quiescence", "check", "", "true", false},
+    {"NoRandom", "check", "", "false", false},
+    {"Threads", "spin", "min 0 max 256", "1", false},
+    {"MoveTimeMS", "spin", "min 0 max 86400000", "0", false},
+    {"HashMB", "spin", "min 0 max 65536", "0", true},
+    {"TablebasePath", "string", "", "<empty>", true},
+    {"BookPath", "string", "", "<empty>", true},
+};
+
+// Значение настройки из текста команды setoption
+json option_value(const engine_option& option, const string& text)
+{
+    if (string(option.type) == "check")
+        return text == "true";
+    if (string(option.type) == "spin")
+        return max(0, atoi(text.c_str()));
+    return text;
+}
+
+// Значение настройки в тексте ответа на uci
+string option_text(const engine_option& option, const json& value)
+{
+    if (value.is_null())
+        return option.absent;
+    if (value.is_string())
+        return value.get<string>().empty() ? "<empty>" : value.get<string>();
+    return value.dump();
+}
+
+// Таблицы, общие для всех сессий: таблица транспозиций, эндшпильная база и дебютная книга
+//
+// Их держит объект Logic, который сам не ищет: сессии берут таблицы у него через share_tables.
+// Смена HashMB, TablebasePath или BookPath создаёт новый такой объект; сессии переходят на него
+// перед следующим поиском, а старые таблицы живут, пока ими пользуются начатые поиски.
+class SharedTables
+{
+public:
+    explicit SharedTables(const Config& settings) : config(settings)
+    {
+        rebuild();
+    }
+
+    void set(const string& name, const json& value)
+    {
+        lock_guard<mutex> lock(guard);
+        config.set("Bot", name, value);
+        rebuild();
+    }
+
+    json get(const string& name)
+    {
+        lock_guard<mutex> lock(guard);
+        return config("Bot", name);
+    }
+
+    // Владелец текущих таблиц и номер их версии (растёт при каждой смене)
+    pair<shared_ptr<const Logic>, uint64_t> current()
+    {
+        lock_guard<mutex> lock(guard);
+        return {owner, version};
+    }
+
+private:
+    void rebuild()
+    {
+        owner = make_shared<Logic>(&board, &config);
+        ++version;
+    }
+
+    mutex guard;
+    Config config;
+    BoardState board; // Нужна только конструктору Logic
+    shared_ptr<Logic> owner;
+    uint64_t version = 0;
+};
+
+// Канал строк протокола: stdin/stdout или соединение с сокетом
+class Channel
+{
+public:
+    virtual ~Channel() = default;
+    // Следующая строка без перевода строки; false, когда ввод закончился
+    virtual bool read_line(string& line) = 0;
+    // Пишет текст целиком (вызывается под замком сессии)
+    virtual void write(const string& text) = 0;
+};
+
+class StdioChannel : public Channel
+{
+public:
+    bool read_line(string& line) override
+    {
+        return bool(getline(cin, line));
+    }
+    void write(const string& text) override
+    {
+        fwrite(text.data(), 1, text.size(), stdout);
+        fflush(stdout);
+    }
+};
+
+#ifndef _WIN32
+class SocketChannel : public Channel
+{
+public:
+    explicit SocketChannel(const int fd) : fd(fd)
+    {}
+    ~SocketChannel() override
+    {
+        close(fd);
+    }
+
+    bool read_line(string& line) override
+    {
+        while (true)
+        {
+            const size_t end = buffer.find('\n');
+            if (end != string::npos)
+            {
+                line = buffer.substr(0, end);
+                buffer.erase(0, end + 1);
+                return true;
+            }
+            char chunk[4096];
+            const ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if (got <= 0)
+                return false; // соединение закрыто
+            buffer.append(chunk, size_t(got));
+        }
+    }
+    void write(const string& text) override
+    {
+        for (size_t sent = 0; sent < text.size();)
+        {
+            const ssize_t done = send(fd, text.data() + sent, text.size() - sent, 0);
+            if (done <= 0)
+                return; // клиент ушёл, команды из сессии тоже закончатся
+            sent += size_t(done);
+        }
+    }
+
+private:
+    int fd;
+    string buffer; // Принятые, но ещё не разобранные байты
+};
+#endif
+
+// Сессия протокола: позиция, настройки поиска и поток поиска одного клиента
+class Session
+{
+public:
+    Session(Channel& channel, SharedTables& shared, const Config& settings)
+        : channel(channel), shared(shared), config(settings)
+    {
+        // таблицы сессия берёт у общего владельца, своих не создаёт
+        config.set("Bot", "HashMB", 0);
+        config.set("Bot", "TablebasePath", "");
+        config.set("Bot", "BookPath", "");
+        new_game();
+    }
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+    ~Session()
+    {
+        stop_search();
+    }
+
+    // Обрабатывает команды до quit или конца ввода
+    void run()
+    {
+        string line;
+        while (channel.read_line(line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!handle(line))
+                break;
+        }
+    }
+
+private:
+    // Выполняет одну команду; false — конец сессии
+    bool handle(const string& line)
+    {
+        istringstream args(line);
+        string command;
+        if (!(args >> command))
+            return true;
+        if (command == "uci")
+        {
+            string text = "id name Checkers\n";
+            for (const engine_option& option : engine_options)
+            {
+                const json value = option.shared ? shared.get(option.name) : config("Bot", option.name);
+                text += string("option name ") + option.name + " type " + option.type + " default " +
+                        option_text(option, value) + (*option.range ? " " : "") + option.range + "\n";
+            }
+            send(text + "uciok\n");
+        }
+        else if (command == "isready")
+            send("readyok\n");
+        else if (command == "setoption")
+            set_option(args);
+        else if (command == "ucinewgame")
+        {
+            stop_search();
+            new_game();
+        }
+        else if (command == "position")
+        {
+            stop_search();
+            set_position(args);
+        }
+        else if (command == "go")
+            go(args);
+        else if (command == "stop")
+            stop_search();
+        else if (command == "ponderhit")
+            ponder_hit();
+        else if (command == "quit")
+            return false;
+        else
+            send("info string unknown command " + command + "\n");
+        return true;
+    }
+
+    void send(const string& text)
+    {
+        lock_guard<mutex> lock(output);
+        channel.write(text);
+    }
+
+    void new_game()
+    {
+        BoardState board;
+        board.reset();
+        pos = Position(board.get_board(), 0);
+    }
+
+    // setoption name <Key> value <V> (значение может содержать пробелы: путь к файлу)
+    void set_option(istringstream& args)
+    {
+        string word, name, text;
+        args >> word >> name;
+        args >> word;
+        getline(args >> ws, text);
+        for (const engine_option& option : engine_options)
+        {
+            if (name != option.name)
+                continue;
+            const json value = option_value(option, text == "<empty>" ? "" : text);
+            if (option.shared)
+                shared.set(name, value);
+            else
+            {
+                stop_search();
+                config.set("Bot", name, value);
+                logic.reset(); // поиск пересоздаётся с новыми настройками при следующем go
+            }
+            return;
+        }
+        send("info string unknown option " + name + "\n");
+    }
+
+    // position startpos|fen <FEN> [moves ...]
+    void set_position(istringstream& args)
+    {
+        string word;
+        args >> word;
+        if (word == "startpos")
+            new_game();
+        else if (word == "fen")
+        {
+            string fen;
+            args >> fen;
+            try
+            {
+                pos = Position::from_fen(fen);
+            }
+            catch (const exception& e)
+            {
+                send(string("info string ") + e.what() + "\n");
+                return;
+            }
+        }
+        if (!(args >> word) || word != "moves")
+            return;
+        while (args >> word)
+        {
+            bool found = false;
+            Position next;
+            moves.for_each(pos, [&](const Position& after, const vector<move_pos>& line) {
+                if (!found && FullMoves::notation(line) == word)
+                {
+                    found = true;
+                    next = after;
+                }
+            });
+            if (!found)
+            {
+                send("info string illegal move " + word + "\n");
+                return; // позиция остаётся после последнего допустимого хода
+            }
+            pos = next;
+        }
+    }
+
+    // go [depth D] [movetime MS] [infinite] [ponder]
+    void go(istringstream& args)
+    {
+        stop_search();
+        int depth = 0;
+        unsigned int move_time = 0;
+        bool infinite = false, ponder = false;
+        string word;
+        while (args >> word)
+        {
+            if (word == "depth")
+                args >> depth;
+            else if (word == "movetime")
+                args >> move_time;
+            else if (word == "infinite")
+                infinite = true;
+            else if (word == "ponder")
+                ponder = true;
+        }
+        if (!depth && !move_time && !infinite && !ponder)
+        {
+            const auto default_time = config("Bot", "MoveTimeMS");
+            move_time = default_time.is_number() ? default_time.get<unsigned int>() : 0;
+        }
+
+        prepare_logic();
+        logic->Max_depth = depth > 0 ? min(depth, max_search_depth) : max_search_depth;
+        // бюджет действует сразу только для обычного go; после go ponder — с ponderhit
+        logic->set_move_time(move_time && !ponder && !infinite ? move_time : unlimited_ms);
+        logic->resume();
+        {
+            lock_guard<mutex> lock(state);
+            finished = false;
+            reported = false;
+            held = infinite || ponder;
+            ponder_time = ponder ? move_time : 0;
+            root = pos;
+        }
+        searcher = thread([this]() {
+            const vector<move_pos> best = logic->find_best_turns(root);
+            lock_guard<mutex> lock(state);
+            result = best;
+            finished = true;
+            if (!held)
+                report();
+            search_done.notify_all();
+        });
+    }
+
+    // ponderhit: соперник сделал предсказанный ход, размышление становится обычным поиском
+    void ponder_hit()
+    {
+        unique_lock<mutex> lock(state);
+        if (!searcher.joinable() || !held)
+            return;
+        held = false;
+        if (finished)
+        {
+            report();
+            return;
+        }
+        if (!ponder_time)
+            return; // без бюджета поиск идёт до stop или до своей глубины
+        const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(ponder_time);
+        lock.unlock();
+        timer = thread([this, deadline]() {
+            unique_lock<mutex> lock(state);
+            if (!search_done.wait_until(lock, deadline, [this]() { return finished; }))
+                logic->cancel(); // бюджет вышел: берётся последняя завершённая итерация
+        });
+    }
+
+    // Останавливает поиск, если он идёт, и дожидается его хода
+    void stop_search()
+    {
+        if (!searcher.joinable())
+            return;
+        {
+            lock_guard<mutex> lock(state);
+            held = false;
+            if (finished)
+                report();
+        }
+        logic->cancel();
+        searcher.join();
+        if (timer.joinable())
+            timer.join();
+    }
+
+    // Пересоздаёт поиск после смены настроек сессии и подключает текущие общие таблицы
+    void prepare_logic()
+    {
+        const auto tables = shared.current();
+        if (!logic)
+        {
+            logic = make_unique<Logic>(&board, &config);
+            tables_version = 0;
+        }
+        if (tables_version != tables.second)
+        {
+            logic->share_tables(*tables.first);
+            tables_version = tables.second;
+        }
+    }
+
+    // Выдаёт результат поиска (вызывается под замком state один раз на go)
+    void report()
+    {
+        if (reported)
+            return;
+        reported = true;
+        const SearchStats& stats = logic->stats;
+        vector<string> line;
+        if (!result.empty())
+            line = moves.principal_variation(*logic, root, result, size_t(max(stats.depth, 0)) + 1);
+        else
+        {
+            // поиск остановлен до конца первой итерации: любой допустимый ход лучше, чем никакого
+            moves.for_each(root, [&](const Position&, const vector<move_pos>& turns) {
+                if (line.empty())
+                    line.push_back(FullMoves::notation(turns));
+            });
+        }
+        if (line.empty())
+        {
+            send("bestmove (none)\n"); // ходить нечем
+            return;
+        }
+        string text;
+        if (stats.book)
+            text = "info string book move " + line[0]; // ход из дебютной книги, без поиска
+        else
+        {
+            text = "info depth " + to_string(stats.depth) + " score cp " + to_string(lround(stats.score * 100)) +
+                   " nodes " + to_string(stats.nodes) + " nps " + to_string(stats.nps()) + " time " +
+                   to_string(lround(stats.time_ms)) + " pv";
+            for (const string& turn : line)
+                text += " " + turn;
+        }
+        text += "\nbestmove " + line[0];
+        if (line.size() > 1)
+            text += " ponder " + line[1];
+        send(text + "\n");
+    }
+
+    Channel& channel;
+    SharedTables& shared;
+    Config config;         // Настройки сессии (setoption), таблицы в них отключены
+    BoardState board;      // Нужна только конструктору Logic
+    unique_ptr<Logic> logic;
+    uint64_t tables_version = 0; // Версия общих таблиц, подключённых к logic
+    FullMoves moves;       // Разбор ходов и линий; только для потока команд или под замком state
+    Position pos;          // Позиция, заданная командой position
+
+    mutex output; // Строки из потока команд и потока поиска не перемешиваются
+    mutex state;
+    condition_variable search_done;
+    thread searcher;
+    thread timer;                  // Ограничение времени после ponderhit
+    Position root;                 // Позиция текущего поиска
+    vector<move_pos> result;       // Найденный ход
+    bool finished = false;         // Поиск закончился
+    bool held = false;             // Ход выдаётся только по stop или ponderhit (go infinite, go ponder)
+    bool reported = false;         // bestmove уже выдан
+    unsigned int ponder_time = 0;  // Бюджет, начинающийся с ponderhit
+};
+
+#ifndef _WIN32
+// Принимает соединения с сокетом path и обслуживает каждое в своём потоке
+int serve_socket(const string& path, SharedTables& shared, const Config& settings)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "socket path is too long: %s\n", path.c_str());
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str()); // сокет, оставшийся от прошлого запуска
+    if (server < 0 || bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(server, 16) != 0)
+    {
+        fprintf(stderr, "cannot listen on %s: %s\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // запись в закрытое соединение — ошибка send, а не завершение процесса
+    while (true)
+    {
+        const int client = accept(server, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "accept failed: %s\n", strerror(errno));
+            return 1;
+        }
+        thread([client, &shared, &settings]() {
+            SocketChannel channel(client);
+            Session session(channel, shared, settings);
+            session.run();
+        }).detach();
+    }
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    if (argc % 2 == 0)
+    {
+        fprintf(stderr, "usage: %s [--socket PATH] [--settings settings.json]\n", argv[0]);
+        return 1;
+    }
+    string socket_path, settings_path;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const string option = argv[i];
+        if (option == "--socket")
+            socket_path = argv[i + 1];
+        else if (option == "--settings")
+            settings_path = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option.c_str());
+            return 1;
+        }
+    }
+    const Config settings = settings_path.empty() ? Config() : Config(settings_path);
+    SharedTables shared(settings);
+    if (!socket_path.empty())
+    {
+#ifndef _WIN32
+        return serve_socket(socket_path, shared, settings);
+#else
+        fprintf(stderr, "--socket is not supported on Windows\n");
+        return 1;
+#endif
+    }
+    StdioChannel channel;
+    Session session(channel, shared, settings);
+    session.run();
+    return 0;
+}
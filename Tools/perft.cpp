@@ -0,0 +1,153 @@
+// Perft: подсчёт листьев дерева ходов до заданной глубины.
+//
+// Служит проверкой генератора ходов Logic::find_turns и мерой его скорости.
+// Ход — это полный ход игрока: серия взятий считается одним ходом, и каждая
+// различная последовательность взятий даёт отдельный ход.
+//
+// Использование:
+//   checkers_perft [--fen FEN] [--depth N] [--divide]   подсчёт для позиции (по умолчанию начальной)
+//   checkers_perft --verify                             сверка с таблицей известных значений
+// Настройки бота берутся из settings.json в текущем каталоге, как и в игре.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Full_moves.h"
+#include "../Game/Logic.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+const string start_fen = "W:Wa1,c1,e1,g1,b2,d2,f2,h2,a3,c3,e3,g3:Bb6,d6,f6,h6,a7,c7,e7,g7,b8,d8,f8,h8";
+
+// Известные значения perft по правилам игры (шашки бьют и назад, дамка дальнобойная,
+// шашка, дошедшая до края во время взятия, продолжает бить уже как дамка).
+// Значения совпадают с прежним генератором ходов, работавшим на матрице доски.
+struct known_perft
+{
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+const known_perft known[] = {
+    {"start", start_fen.c_str(), 1, 7},
+    {"start", start_fen.c_str(), 2, 49},
+    {"start", start_fen.c_str(), 3, 302},
+    {"start", start_fen.c_str(), 4, 1469},
+    {"start", start_fen.c_str(), 5, 7482},
+    {"start", start_fen.c_str(), 6, 37986},
+    {"start", start_fen.c_str(), 7, 190146},
+    {"start", start_fen.c_str(), 8, 929984},
+    // Дамки бьют сериями с выбором поля остановки
+    {"kings-1", "W:WKa1,Kh2:Bc3,e5,b6,f6,d8", 6, 13021},
+    {"kings-1", "W:WKa1,Kh2:Bc3,e5,b6,f6,d8", 8, 414332},
+    {"kings-2", "B:Wc3,e3,g3,Kd2:BKh8,b6,d6,f6", 6, 42887},
+    {"kings-3", "W:WKc1,e1,a3:Bd2,b4,f4,d6,f6,Kh8", 6, 20499},
+    {"kings-3", "W:WKc1,e1,a3:Bd2,b4,f4,d6,f6,Kh8", 8, 883270},
+    {"kings-4", "B:WKa1,Kh8,c5,e5:BKb8,d4,f4,g7", 6, 33104},
+    {"kings-4", "B:WKa1,Kh8,c5,e5:BKb8,d4,f4,g7", 8, 2260233},
+    // Шашка превращается в дамку посреди серии взятий (d6:f8:h6)
+    {"promotion", "W:Wd6,a1,c1:Be7,g7,b8,h8", 6, 892},
+    {"promotion", "W:Wd6,a1,c1:Be7,g7,b8,h8", 8, 19152},
+};
+
+// Счётчик perft поверх перебора полных ходов
+class Perft
+{
+public:
+    // Число листьев на глубине depth полных ходов
+    uint64_t count(Position& pos, const int depth)
+    {
+        if (depth == 0)
+            return 1;
+        uint64_t nodes = 0;
+        moves.for_each(pos, [&](const Position&, const vector<move_pos>&) { nodes += count(pos, depth - 1); });
+        return nodes;
+    }
+
+    // Подсчёт с разбивкой по ходам из корня: ход в нотации и число листьев после него
+    vector<pair<string, uint64_t>> divide(Position& pos, const int depth)
+    {
+        vector<pair<string, uint64_t>> result;
+        if (depth == 0)
+            return result;
+        moves.for_each(pos, [&](const Position&, const vector<move_pos>& line) {
+            result.emplace_back(FullMoves::notation(line), count(pos, depth - 1));
+        });
+        return result;
+    }
+
+private:
+    FullMoves moves;
+};
+
+int main(int argc, char* argv[])
+{
+    string fen = start_fen;
+    int depth = 6;
+    bool divide = false, verify = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string option = argv[i];
+        if (option == "--fen" && i + 1 < argc)
+            fen = argv[++i];
+        else if (option == "--depth" && i + 1 < argc)
+            depth = atoi(argv[++i]);
+        else if (option == "--divide")
+            divide = true;
+        else if (option == "--verify")
+            verify = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--fen FEN] [--depth N] [--divide] | --verify\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Perft perft;
+
+    if (verify)
+    {
+        int failed = 0;
+        uint64_t total = 0;
+        const auto start = chrono::steady_clock::now();
+        for (const auto& k : known)
+        {
+            Position pos = Position::from_fen(k.fen);
+            const uint64_t nodes = perft.count(pos, k.depth);
+            total += nodes;
+            printf("%-12s depth %2d: %12llu %s\n", k.name, k.depth, (unsigned long long)nodes,
+                   nodes == k.nodes ? "ok" : "FAILED");
+            failed += (nodes != k.nodes);
+        }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("%d failed, %llu nodes  time %.3f s  %.0f nodes/s\n", failed, (unsigned long long)total, seconds,
+               seconds > 0 ? total / seconds : 0.0);
+        return failed ? 1 : 0;
+    }
+
+    Position pos = Position::from_fen(fen);
+    const auto start = chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    if (divide)
+    {
+        for (const auto& [move, count] : perft.divide(pos, depth))
+        {
+            printf("%s %llu\n", move.c_str(), (unsigned long long)count);
+            nodes += count;
+        }
+    }
+    else
+        nodes = perft.count(pos, depth);
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("perft(%d) = %llu  time %.3f s  %.0f nodes/s\n", depth, (unsigned long long)nodes, seconds,
+           seconds > 0 ? nodes / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,305 @@
+// Генератор эндшпильной базы (Game/Tablebase.h) ретроградным анализом.
+//
+// Срезы строятся по возрастанию числа фигур, а при равном числе — по возрастанию числа шашек:
+// взятие уменьшает число фигур, превращение — число шашек, поэтому к началу работы над срезом
+// все срезы, в которые из него можно уйти, уже готовы.
+// Внутри среза значения находятся проходами по возрастанию расстояния: на проходе n позиция
+// выигрывает за n ходов, если есть ход в проигрыш за n - 1, и проигрывает через n,
+// если все ходы ведут в выигрыш соперника и самый долгий из них — за n - 1.
+// Позиции, не решённые ни на одном проходе, — ничейные.
+//
+// Использование:
+//   checkers_tbgen <output.tb> [--pieces N]   построение базы (по умолчанию N = 4)
+//   checkers_tbgen <file.tb> --probe FEN       значение позиции из готовой базы
+// Настройки бота берутся из settings.json в текущем каталоге, как и в игре.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../Game/Board_state.h"
+#include "../Game/Config.h"
+#include "../Game/Full_moves.h"
+#include "../Game/Logic.h"
+#include "../Game/Tablebase.h"
+#include "../Models/Position.h"
+
+using namespace std;
+
+// Состав материала среза
+struct material
+{
+    int white_men, black_men, white_kings, black_kings;
+};
+
+class Generator
+{
+public:
+    explicit Generator(const int max_pieces) : max_pieces(max_pieces)
+    {
+        slices.resize(Tablebase::slice_count(max_pieces));
+        // все сочетания клеток для групп из k фигур (в порядке возрастания номера сочетания)
+        masks.resize(max_pieces + 1);
+        for (int k = 0; k <= max_pieces; ++k)
+        {
+            if (k == 0)
+            {
+                masks[k].push_back(0);
+                continue;
+            }
+            for (uint64_t mask = (1ull << k) - 1; mask < (1ull << 32);)
+            {
+                masks[k].push_back(uint32_t(mask));
+                const uint64_t low = mask & (~mask + 1), ripple = mask + low; // следующее сочетание (Gosper)
+                mask = (((ripple ^ mask) >> 2) / low) | ripple;
+            }
+        }
+    }
+
+    // Строит все срезы с числом фигур до max_pieces
+    void run()
+    {
+        vector<material> order;
+        for (int wm = 0; wm <= max_pieces; ++wm)
+            for (int bm = 0; wm + bm <= max_pieces; ++bm)
+                for (int wk = 0; wm + bm + wk <= max_pieces; ++wk)
+                    for (int bk = 0; wm + bm + wk + bk <= max_pieces; ++bk)
+                        if (wm + wk > 0 && bm + bk > 0)
+                            order.push_back({wm, bm, wk, bk});
+        stable_sort(order.begin(), order.end(), [](const material& a, const material& b) {
+            const int pieces_a = a.white_men + a.black_men + a.white_kings + a.black_kings;
+            const int pieces_b = b.white_men + b.black_men + b.white_kings + b.black_kings;
+            if (pieces_a != pieces_b)
+                return pieces_a < pieces_b;
+            return a.white_men + a.black_men < b.white_men + b.black_men;
+        });
+        for (const auto& m : order)
+            build(m);
+    }
+
+    // Записывает базу в файл
+    bool write(const string& path) const
+    {
+        ofstream fout(path, ios::binary | ios::trunc);
+        if (!fout)
+            return false;
+        tb_header header{{'C', 'K', 'T', 'B'}, tb_version, uint32_t(max_pieces), 0};
+        fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t offset = sizeof(header) + slices.size() * sizeof(uint64_t);
+        for (const auto& slice : slices)
+        {
+            const uint64_t value = slice.empty() ? tb_no_slice : offset;
+            fout.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            offset += slice.size();
+        }
+        for (const auto& slice : slices)
+            fout.write(reinterpret_cast<const char*>(slice.data()), streamsize(slice.size()));
+        return bool(fout);
+    }
+
+private:
+    // Решает один срез
+    void build(const material& m)
+    {
+        const auto start = chrono::steady_clock::now();
+        const size_t slice = Tablebase::slice_id(m.white_men, m.black_men, m.white_kings, m.black_kings, max_pieces);
+        vector<uint8_t>& values = slices[slice];
+        values.assign(Tablebase::slice_size(m.white_men, m.black_men, m.white_kings, m.black_kings), tb_value::INVALID);
+
+        // перечисляем все допустимые позиции среза: фигуры на разных клетках,
+        // белые шашки не на первом ряду сверху (клетки 0–3), чёрные — не на последнем (28–31)
+        vector<Position> positions;
+        for (const uint32_t wm : masks[m.white_men])
+        {
+            if (wm & 0x0000000Fu)
+                continue;
+            for (const uint32_t bm : masks[m.black_men])
+            {
+                if ((bm & 0xF0000000u) || (bm & wm))
+                    continue;
+                for (const uint32_t wk : masks[m.white_kings])
+                {
+                    if (wk & (wm | bm))
+                        continue;
+                    for (const uint32_t bk : masks[m.black_kings])
+                    {
+                        if (bk & (wm | bm | wk))
+                            continue;
+                        Position pos;
+                        pos.white = wm | wk;
+                        pos.black = bm | bk;
+                        pos.kings = wk | bk;
+                        for (const bool color : {false, true})
+                        {
+                            pos.color = color;
+                            values[Tablebase::index(pos)] = tb_value::DRAW;
+                            positions.push_back(pos);
+                        }
+                    }
+                }
+            }
+        }
+
+        // ходы генерируются один раз: ходы внутри среза запоминаются индексами,
+        // а значения ходов в готовые срезы сводятся в node (они уже не меняются)
+        vector<node> nodes(positions.size());
+        vector<uint32_t> inner;
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            node& n = nodes[i];
+            n.index = Tablebase::index(positions[i]);
+            n.first = inner.size();
+            moves.for_each(positions[i], [&](const Position& next, const vector<move_pos>&) {
+                n.has_moves = true;
+                if (next.pieces(next.color) && Tablebase::slice_id(next, max_pieces) == slice)
+                {
+                    inner.push_back(uint32_t(Tablebase::index(next)));
+                    return;
+                }
+                add_value(n, lookup(next));
+            });
+            n.last = inner.size();
+        }
+        positions.clear();
+        positions.shrink_to_fit();
+
+        // проходы по возрастанию расстояния; пока не пройдено самое долгое расстояние
+        // уже готовых срезов, пустой проход ещё не означает конца
+        size_t solved = 0;
+        for (int distance = 0; distance <= tb_value::MAX_DISTANCE; ++distance)
+        {
+            size_t changed = 0;
+            for (const node& n : nodes)
+            {
+                if (values[n.index] != tb_value::DRAW)
+                    continue;
+                node summary = n;
+                for (size_t j = n.first; j < n.last; ++j)
+                    add_value(summary, values[inner[j]]);
+                const uint8_t result = solve(summary, distance);
+                if (result != tb_value::DRAW)
+                {
+                    values[n.index] = result;
+                    ++changed;
+                }
+            }
+            solved += changed;
+            if (changed)
+                longest = max(longest, distance);
+            if (!changed && distance > longest)
+                break;
+        }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("wm %d bm %d wk %d bk %d: %zu positions, %zu decided, %.1f s\n", m.white_men, m.black_men, m.white_kings,
+               m.black_kings, nodes.size(), solved, seconds);
+        fflush(stdout);
+    }
+
+    // Позиция среза и сводка значений её ходов
+    struct node
+    {
+        uint64_t index = 0;          // Индекс позиции в срезе
+        size_t first = 0, last = 0;  // Ходы внутри среза: индексы inner[first, last)
+        bool has_moves = false;      // Есть хотя бы один ход
+        bool opponent_wins = true;   // Все учтённые ходы ведут в выигрыш соперника
+        int shortest_loss = 1 << 30; // Самый быстрый проигрыш соперника среди учтённых ходов
+        int longest_win = 0;         // Самый долгий выигрыш соперника среди учтённых ходов
+    };
+
+    // Учитывает в сводке значение позиции после хода (для соперника)
+    static void add_value(node& n, const uint8_t v)
+    {
+        if (v >= tb_value::LOSS)
+        {
+            n.shortest_loss = min(n.shortest_loss, v - tb_value::LOSS);
+            n.opponent_wins = false;
+        }
+        else if (v == tb_value::DRAW)
+            n.opponent_wins = false;
+        else
+            n.longest_win = max(n.longest_win, int(v));
+    }
+
+    // Значение позиции на проходе distance (DRAW, если на этом проходе она не решается)
+    static uint8_t solve(const node& n, const int distance)
+    {
+        if (!n.has_moves)
+            return distance == 0 ? tb_value::LOSS : tb_value::DRAW;
+        if (n.shortest_loss == distance - 1) // есть ход в проигрыш соперника
+            return uint8_t(distance);
+        if (n.opponent_wins && n.longest_win == distance - 1) // все ходы ведут в выигрыш соперника
+            return uint8_t(tb_value::LOSS + distance);
+        return tb_value::DRAW;
+    }
+
+    // Значение позиции после хода из уже готового среза
+    uint8_t lookup(const Position& pos) const
+    {
+        if (!pos.pieces(pos.color))
+            return tb_value::LOSS; // фигур не осталось — проигрыш
+        return slices[Tablebase::slice_id(pos, max_pieces)][Tablebase::index(pos)];
+    }
+
+    FullMoves moves;
+    int max_pieces;
+    // Срезы по номеру Tablebase::slice_id (пустой вектор — срез не строится)
+    vector<vector<uint8_t>> slices;
+    // Сочетания клеток для групп из k фигур
+    vector<vector<uint32_t>> masks;
+    // Самое долгое расстояние среди уже решённых позиций
+    int longest = 0;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <output.tb> [--pieces N] | <file.tb> --probe FEN\n", argv[0]);
+        return 1;
+    }
+    int pieces = 4;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        const string option = argv[i];
+        if (option == "--pieces")
+            pieces = atoi(argv[i + 1]);
+        else if (option == "--probe")
+        {
+            Tablebase tablebase;
+            if (!tablebase.open(argv[1]))
+            {
+                fprintf(stderr, "can't open %s\n", argv[1]);
+                return 1;
+            }
+            uint8_t value;
+            if (!tablebase.probe(Position::from_fen(argv[i + 1]), value))
+                printf("not in tablebase\n");
+            else if (value == tb_value::DRAW)
+                printf("draw\n");
+            else if (value < tb_value::LOSS)
+                printf("win in %d\n", int(value));
+            else
+                printf("loss in %d\n", value - tb_value::LOSS);
+            return 0;
+        }
+    }
+    if (pieces < 2 || pieces > 6)
+    {
+        fprintf(stderr, "--pieces must be from 2 to 6\n");
+        return 1;
+    }
+
+    Generator generator(pieces);
+    generator.run();
+    if (!generator.write(argv[1]))
+    {
+        fprintf(stderr, "can't write %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}